@@ -0,0 +1,98 @@
+/*
+ * Counts heap allocations made by complete help_handler calls, setup included, through __libc_malloc wrappers
+ * (glibc only). Built with HELP_HANDLER_NO_REGEX it fails if there are any; with regexes it only reports them,
+ * since glibc's regexec() allocates on every call
+ *
+ * gcc -std=c99 -O2 -DHELP_HANDLER_NO_REGEX alloc.c -o alloc && ./alloc
+ * gcc -std=c99 -O2 alloc.c -o alloc && ./alloc
+ */
+#define _POSIX_C_SOURCE 200809L
+#include "../help_handler.h"
+
+
+
+
+static unsigned long long allocations = 0;
+
+#ifdef __GLIBC__
+extern void* __libc_malloc(size_t size);
+extern void* __libc_calloc(size_t count, size_t size);
+extern void* __libc_realloc(void* p, size_t size);
+extern void  __libc_free(void* p);
+
+void* malloc(size_t size)               { allocations++; return __libc_malloc(size); }
+void* calloc(size_t count, size_t size) { allocations++; return __libc_calloc(count, size); }
+void* realloc(void* p, size_t size)     { allocations++; return __libc_realloc(p, size); }
+void  free(void* p)                     { __libc_free(p); }
+#endif
+
+
+static char buffer[1 << 12];
+static size_t length = 0;
+static const char* help_file = "/tmp/help_handler_alloc_help.txt";
+
+static void provider(help_handler_writer write, void* context) {
+    (void)context;
+    write("usage: app [options]", 20);
+}
+
+static unsigned long long count(const char* label, int argc, char** argv, int kind) {
+    unsigned long long before = allocations;
+    length = 0;
+
+    switch (kind) {
+        case 0: help_handler_info("  app  ", "1.0"); break;
+        case 1: help_handler_info_d("app", 2.5); break;
+        case 2: help_handler_name_w(L"app"); break;
+        case 3: help_handler(argc, argv, "usage: app [options]"); break;
+        case 4: help_handler(argc, argv, NULL); break;
+        case 5: help_handler_w(argc, argv, L"usage: app [options]"); break;
+        case 6: help_handler_p(argc, argv, provider, NULL); break;
+        case 7: help_handler_f(argc, argv, help_file); break;
+    }
+
+    unsigned long long made = allocations - before;
+    printf("%-40s %llu\n", label, made);
+    return made;
+}
+
+
+
+
+int main(void) {
+    char* help[]    = { "app", "--help" };
+    char* version[] = { "app", "-v" };
+    char* both[]    = { "app", "--version", "--help" };
+    char* none[]    = { "app", "build", "--release" };
+    char* noargs[]  = { "app" };
+    unsigned long long total = 0;
+
+    FILE* fp = fopen(help_file, "wb");
+    fputs("usage: app [options]\n", fp);
+    fclose(fp);
+
+    help_handler_sink_buffer(buffer, sizeof(buffer), &length);
+    help_handler_config(true, true, true);
+
+    total += count("help_handler_info", 0, NULL, 0);
+    total += count("help_handler_info_d", 0, NULL, 1);
+    total += count("help_handler_name_w", 0, NULL, 2);
+    help_handler_info("app", "1.0");
+    total += count("help_handler --help", 2, help, 3);
+    total += count("help_handler -v", 2, version, 3);
+    total += count("help_handler --version --help", 3, both, 3);
+    total += count("help_handler unmatched", 3, none, 3);
+    total += count("help_handler no arguments", 1, noargs, 3);
+    total += count("help_handler NULL help", 2, help, 4);
+    total += count("help_handler_w --help", 2, help, 5);
+    total += count("help_handler_p --help", 2, help, 6);
+    total += count("help_handler_f --help", 2, help, 7);
+    remove(help_file);
+
+    printf("%-40s %llu\n", "total", total);
+    #ifdef HELP_HANDLER_NO_REGEX
+    return total == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+    #else
+    return EXIT_SUCCESS;
+    #endif
+}
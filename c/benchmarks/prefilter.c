@@ -0,0 +1,118 @@
+/*
+ * A 100k argument argv of paths, UUIDs and --key=value options, 20 to 120 bytes, none of them help or version. Times
+ * help_handler() per argument, next to the same patterns run on every argument with no prefilter in front (what
+ * arg_match() used to do), and the prefilter alone with each of its loops. Build it both ways to compare the regex
+ * path with the hand-written matcher:
+ *
+ * gcc -std=c99 -O2 prefilter.c -o prefilter && ./prefilter
+ * gcc -std=c99 -O2 -DHELP_HANDLER_NO_REGEX prefilter.c -o prefilter && ./prefilter
+ */
+#define _POSIX_C_SOURCE 200809L
+#include "../help_handler.h"
+
+#include <time.h>
+
+
+
+
+#define ARGUMENTS 100000
+
+static char buffer[1 << 12];
+static size_t length = 0;
+static volatile unsigned int sink_bits;
+
+static const char* directories[] = { "home", "alice", "usr", "local", "share", "src", "lib", "build", "release", "data",
+                                     "var", "cache", "opt", "include", "project", "service", "scheduler", "core", "net",
+                                     "storage", "tests", "fixtures", "assets", "images", "third_party", "modules" };
+static const char* extensions[] = { ".c", ".h", ".o", ".json", ".txt", ".png", ".tar.gz", ".log" };
+
+static unsigned int seed = 12345;
+static unsigned int next(void) {
+    seed = seed * 1103515245 + 12345;
+    return seed >> 8;
+}
+
+//A path, a UUID or an option with a path value, 20 to 120 bytes
+static char* argument(void) {
+    char* arg = malloc(160);
+    size_t at = 0;
+    const unsigned int kind = next() % 10;
+    if (kind == 0) {
+        for (int i = 0; i < 16; i++) {
+            at += (size_t)sprintf(arg + at, "%02x%s", next() % 256, i == 3 || i == 5 || i == 7 || i == 9 ? "-" : ""); }
+        return arg; }
+
+    if (kind <= 2) {
+        at += (size_t)sprintf(arg, "--%s=", kind == 1 ? "input" : "output"); }
+    const size_t target = 20 + next() % 100;
+    while (at < target - 12) {
+        at += (size_t)sprintf(arg + at, "/%s", directories[next() % (sizeof(directories) / sizeof(directories[0]))]); }
+    sprintf(arg + at, "/f%05u%s", next() % 100000, extensions[next() % (sizeof(extensions) / sizeof(extensions[0]))]);
+    return arg;
+}
+
+static double seconds(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec + (double)now.tv_nsec / 1e9;
+}
+
+//Best of 5, in ns per argument
+#define TIME(label, body) do { \
+    double best = 1e30; \
+    for (int run = 0; run < 5; run++) { \
+        const double start = seconds(); \
+        body; \
+        const double ns = (seconds() - start) * 1e9 / ARGUMENTS; \
+        best = ns < best ? ns : best; } \
+    printf("%-36s %8.2f ns/argument\n", label, best); \
+} while (0)
+
+int main(void) {
+    static char* argv[ARGUMENTS + 1];
+    argv[0] = "prefilter";
+    size_t bytes = 0;
+    unsigned int through = 0;
+    for (int i = 1; i <= ARGUMENTS; i++) {
+        argv[i] = argument();
+        bytes += strlen(argv[i]);
+        through += arg_prefilter(argv[i]) != 0; }
+
+    help_handler_sink_buffer(buffer, sizeof(buffer), &length);
+    help_handler_config(false, false, false);
+    #ifdef HELP_HANDLER_NO_REGEX
+    printf("hand-written matcher, ");
+    #else
+    printf("regex matcher, ");
+    lex_compile();
+    #endif
+    printf("%d arguments averaging %.1f bytes, %.1f%% let through by the prefilter\n\n",
+           ARGUMENTS, (double)bytes / ARGUMENTS, 100.0 * through / ARGUMENTS);
+
+    TIME("help_handler()", help_handler(ARGUMENTS + 1, argv, "usage: prefilter"));
+    TIME("patterns on every argument", for (int i = 1; i <= ARGUMENTS; i++) { sink_bits = arg_is_help(argv[i]) | arg_is_ver(argv[i]); });
+    TIME("prefilter", for (int i = 1; i <= ARGUMENTS; i++) { sink_bits = arg_prefilter(argv[i]); });
+    TIME("  byte at a time", for (int i = 1; i <= ARGUMENTS; i++) { sink_bits = digrams_scalar(argv[i], strlen(argv[i]), 0, 0); });
+    #ifdef HELP_HANDLER_SSE2_C
+    TIME("  SSE2", for (int i = 1; i <= ARGUMENTS; i++) {
+        size_t at = 0;
+        const size_t len = strlen(argv[i]);
+        unsigned int found = digrams_sse2(argv[i], len, &at, 0);
+        sink_bits = digrams_scalar(argv[i], len, at, found); });
+    #endif
+    #ifdef HELP_HANDLER_AVX2_C
+    if (__builtin_cpu_supports("avx2")) {
+        TIME("  AVX2, then SSE2", for (int i = 1; i <= ARGUMENTS; i++) {
+            size_t at = 0;
+        const size_t len = strlen(argv[i]);
+            unsigned int found = digrams_avx2(argv[i], len, &at, 0);
+            found = digrams_sse2(argv[i], len, &at, found);
+            sink_bits = digrams_scalar(argv[i], len, at, found); }); }
+    #endif
+
+    if (length != 0) {
+        printf("an argument matched, so the numbers above are off\n"); }
+    for (int i = 1; i <= ARGUMENTS; i++) {
+        free(argv[i]); }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,31 @@
+#!/bin/sh
+# How much help_handler.h adds to an executable: a program calling help_handler_info() and help_handler() against an empty main(),
+# both stripped, at each optimisation level. Pass a byte budget to fail when the -O2 delta goes over it; CFLAGS is
+# passed to both builds, so the build without regex.h is measured with
+#
+# CFLAGS=-DHELP_HANDLER_NO_REGEX sh size.sh
+#
+# sh size.sh [budget] (CC overrides the compiler, gcc by default)
+CC=${CC:-gcc}
+DIR=$(cd "$(dirname "$0")" && pwd)
+TMP=$(mktemp -d)
+trap 'rm -rf "$TMP"' EXIT
+
+printf 'int main(void) { return 0; }\n' > "$TMP/base.c"
+printf '#include "%s/../help_handler.h"\nint main(int argc, char** argv) { help_handler_info("app", "1.0"); return help_handler(argc, argv, "usage: app"); }\n' "$DIR" > "$TMP/with.c"
+
+status=0
+printf '%-6s %10s %10s %10s\n' level base with delta
+for level in -O0 -O2 -Os; do
+    $CC -std=c99 $level $CFLAGS -s "$TMP/base.c" -o "$TMP/base" || exit 1
+    $CC -std=c99 $level $CFLAGS -s "$TMP/with.c" -o "$TMP/with" || exit 1
+    base=$(wc -c < "$TMP/base")
+    with=$(wc -c < "$TMP/with")
+    printf '%-6s %10d %10d %10d\n' $level $base $with $((with - base))
+
+    if [ -n "$1" ] && [ $level = -O2 ] && [ $((with - base)) -gt "$1" ]; then
+        echo "over budget: $((with - base)) > $1 bytes" >&2
+        status=1
+    fi
+done
+exit $status
@@ -0,0 +1,156 @@
+/*
+ * A response file of a million paths, ~51MiB, read three ways: help_handler() expanding "@file" with --help and
+ * --version on its first two lines (reading stops there), on its last two (read to the end), and on none, then the
+ * same file as newline separated stdin. Next to them, what a launcher would otherwise do: read the whole file into
+ * memory, split it into an argv and pass that to help_handler(). Reports ms, the most heap in use at once (counted
+ * through __libc_malloc wrappers, glibc only) and bytes read (rchar from /proc/self/io)
+ *
+ * gcc -std=c99 -O2 sources.c -o sources && ./sources
+ */
+#define _GNU_SOURCE
+#include "../help_handler.h"
+
+#include <time.h>
+#include <malloc.h>
+
+
+
+
+#define ARGUMENTS 1000000
+
+static const char* response_file = "/tmp/help_handler_sources.rsp";
+static size_t heap = 0, heap_peak = 0;
+
+extern void* __libc_malloc(size_t size);
+extern void  __libc_free(void* p);
+
+//The reader only ever mallocs and frees; regcomp()'s realloc()s happen once, before anything is measured
+void* malloc(size_t size) {
+    void* p = __libc_malloc(size);
+    heap += p != NULL ? malloc_usable_size(p) : 0;
+    heap_peak = heap > heap_peak ? heap : heap_peak;
+    return p;
+}
+void free(void* p) {
+    heap -= p != NULL ? malloc_usable_size(p) : 0;
+    __libc_free(p);
+}
+
+static long long bytes_read(void) { //-1 when /proc/self/io isn't there
+    FILE* io = fopen("/proc/self/io", "r");
+    if (io == NULL) {
+        return -1; }
+
+    long long value = -1;
+    char line[128];
+    while (fgets(line, sizeof(line), io) != NULL) {
+        if (sscanf(line, "rchar: %lld", &value) == 1) {
+            break; }
+    }
+    fclose(io);
+    return value;
+}
+
+static void write_file(const char* head, const char* tail) { //Either may be NULL
+    FILE* fp = fopen(response_file, "wb");
+    if (head != NULL) {
+        fprintf(fp, "%s\n", head); }
+    for (int i = 0; i < ARGUMENTS - 2; i++) {
+        fprintf(fp, "/srv/data/project-%03d/build/release/objects/%07d.o\n", i % 1000, i); }
+    if (tail != NULL) {
+        fprintf(fp, "%s\n", tail); }
+    fclose(fp);
+}
+
+static void discard(const struct help_handler_fragment* fragments, size_t count, void* context) { //Only the matching is measured
+    (void)fragments; (void)count; (void)context;
+}
+
+static char* at_argv[] = { "app", "@/tmp/help_handler_sources.rsp", NULL };
+
+static int from_file(void) {
+    help_handler_sources(HELP_HANDLER_RESPONSE_FILES);
+    return help_handler(2, at_argv, "usage: app");
+}
+
+static int from_stdin(void) {
+    const int fd = open(response_file, O_RDONLY);
+    dup2(fd, 0);
+    close(fd);
+    help_handler_sources(HELP_HANDLER_STDIN_LINES);
+    return help_handler(1, at_argv, "usage: app");
+}
+
+//What a launcher would do without help_handler_sources(): the whole file in memory, then an argv over its lines
+static int materialized(void) {
+    help_handler_sources(0);
+    FILE* fp = fopen(response_file, "rb");
+    fseek(fp, 0, SEEK_END);
+    const long size = ftell(fp);
+    rewind(fp);
+    char* data = malloc((size_t)size + 1);
+    size_t got = fread(data, 1, (size_t)size, fp);
+    fclose(fp);
+    data[got] = '\0';
+
+    char** argv = malloc(sizeof(char*) * (ARGUMENTS + 2));
+    int argc = 0;
+    argv[argc++] = "app";
+    for (char* line = data; *line != '\0'; ) {
+        char* end = strchr(line, '\n');
+        argv[argc++] = line;
+        if (end == NULL) {
+            break; }
+        *end = '\0';
+        line = end + 1;
+    }
+    argv[argc] = NULL;
+    const int matches = help_handler(argc, argv, "usage: app");
+    free(argv);
+    free(data);
+    return matches;
+}
+
+static void report(const char* label, int (*call)(void)) {
+    call(); //Warm the page cache
+    heap = heap_peak = 0; //Only what the call itself allocates, which it frees again before returning
+    const long long before = bytes_read();
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    call();
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    const double ms = (double)(end.tv_sec - start.tv_sec) * 1e3 + (double)(end.tv_nsec - start.tv_nsec) / 1e6;
+    const long long read = bytes_read() - before;
+
+    char read_text[32] = "-";
+    if (before >= 0) {
+        snprintf(read_text, sizeof(read_text), "%.2f MiB", (double)read / (1 << 20)); }
+    printf("%-40s %9.2f ms   peak heap %8zu KiB   read %12s\n", label, ms, heap_peak / 1024, read_text);
+}
+
+
+
+
+int main(void) {
+    help_handler_info("app", "1.0");
+    help_handler_config(false, false, false);
+    help_handler_sink_callback(discard, NULL);
+    if (freopen("/dev/null", "w", stderr) == NULL) {
+        return EXIT_FAILURE; }
+
+    const struct { const char* label; const char* head; const char* tail; } files[] = {
+        { "on the first two lines", "--help\n--version", NULL },
+        { "on the last two lines", NULL, "--help\n--version" },
+        { "not there", NULL, "--foo\n--bar" },
+    };
+    for (int f = 0; f < 3; f++) {
+        write_file(files[f].head, files[f].tail);
+        printf("help and version %s\n", files[f].label);
+        report("  help_handler(), @file", from_file);
+        report("  help_handler(), stdin", from_stdin);
+        report("  read into memory, then help_handler()", materialized);
+    }
+
+    unlink(response_file);
+    return EXIT_SUCCESS;
+}
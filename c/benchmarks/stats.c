@@ -0,0 +1,90 @@
+/*
+ * Cost of the instrumentation: ns per call for help_handler() and help_handler_f(), and with HELP_HANDLER_STATS the
+ * per-phase breakdown it collected. The last case flips extra_strings on every call, so the regexes are compiled
+ * each time. stats.sh builds it both ways, and checks the disabled build is byte for byte the one without any
+ * instrumentation in the source
+ *
+ * gcc -std=c99 -O2 stats.c -o stats && ./stats
+ * gcc -std=c99 -O2 -DHELP_HANDLER_STATS stats.c -o stats && ./stats
+ */
+#define _POSIX_C_SOURCE 200809L //clock_gettime(), which HELP_HANDLER_STATS times with when it's declared
+#include "../help_handler.h"
+
+#include <time.h>
+
+
+
+
+static const char* help_file = "/tmp/help_handler_stats_help.txt";
+
+static void run(int kind, int argc, char** argv) {
+    static bool extra = true;
+
+    switch (kind) {
+        case 0: help_handler(argc, argv, "usage: stats"); break;
+        case 1: help_handler_f(argc, argv, help_file); break;
+        case 2:
+            extra = !extra;
+            help_handler_config(extra, true, false);
+            help_handler(argc, argv, "usage: stats");
+            break;
+    }
+}
+
+static void measure(const char* label, int kind, int argc, char** argv) {
+    struct timespec start, now;
+    unsigned long long calls = 0;
+    double ns = 0;
+
+    #ifdef HELP_HANDLER_STATS
+    help_handler_reset_stats();
+    #endif
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (unsigned long long batch = 1; ns < 2e8; batch *= 2) {
+        for (unsigned long long i = 0; i < batch; i++) {
+            run(kind, argc, argv); }
+        calls += batch;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        ns = (double)(now.tv_sec - start.tv_sec) * 1e9 + (double)(now.tv_nsec - start.tv_nsec);
+    }
+    printf("%-32s %10.1f ns/call", label, ns / (double)calls);
+
+    #ifdef HELP_HANDLER_STATS
+    struct help_handler_stats s = help_handler_get_stats();
+    printf("   compile %8.1f  match %8.1f  file %8.1f  write %8.1f ns   %.0f args  %.0f bytes",
+           (double)s.compile_ns / (double)s.calls, (double)s.match_ns / (double)s.calls, (double)s.file_ns / (double)s.calls,
+           (double)s.write_ns / (double)s.calls, (double)s.args_scanned / (double)s.calls, (double)s.bytes_written / (double)s.calls);
+    #endif
+    printf("\n");
+}
+
+
+
+
+int main(void) {
+    char* unmatched[] = { "stats", "--input=a.txt", "-o", "out.bin", "--jobs=8", "build", "--quiet", "--dry-run", "--force", "-x", NULL };
+    char* matched[]   = { "stats", "--input=a.txt", "-o", "out.bin", "--jobs=8", "build", "--quiet", "--dry-run", "--force", "--help", NULL };
+    const int argc = 10;
+
+    FILE* fp = fopen(help_file, "wb");
+    for (int i = 0; i < 1024; i++) {
+        fprintf(fp, "  --option-%04d   does something worth a line of help\n", i); }
+    fclose(fp);
+
+    help_handler_info("stats", "1.0");
+    help_handler_sink_fd(open("/dev/null", O_WRONLY));
+
+    #ifdef HELP_HANDLER_STATS
+    printf("HELP_HANDLER_STATS on\n");
+    #else
+    printf("HELP_HANDLER_STATS off\n");
+    #endif
+    measure("help_handler unmatched", 0, argc, unmatched);
+    measure("help_handler matched", 0, argc, matched);
+    measure("help_handler_f 56KiB matched", 1, argc, matched);
+    measure("help_handler unmatched, config", 2, argc, unmatched);
+
+    help_handler_cleanup();
+    remove(help_file);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,28 @@
+#!/bin/sh
+# Checks the instrumentation costs nothing when it isn't enabled: stats.c built against help_handler.h has to come
+# out byte for byte the same as built against a copy with every HELP_HANDLER_STAT_*/HELP_HANDLER_PROBE* use blanked
+# out, at -O2 and stripped. Then runs stats.c with and without HELP_HANDLER_STATS
+#
+# sh stats.sh (CC overrides the compiler, gcc by default)
+CC=${CC:-gcc}
+DIR=$(cd "$(dirname "$0")" && pwd)
+TMP=$(mktemp -d)
+trap 'rm -rf "$TMP"' EXIT
+
+#Blanked rather than deleted, so line numbers (which error messages use) stay the same
+mkdir "$TMP/bare" "$TMP/bare/benchmarks"
+sed -E 's/^[[:space:]]*HELP_HANDLER_(STAT_ADD|STAT_START|STAT_TIME|PROBE[12]?)\(.*$//' "$DIR/../help_handler.h" > "$TMP/bare/help_handler.h"
+cp "$DIR/stats.c" "$TMP/bare/benchmarks/stats.c"
+
+$CC -std=c99 -O2 -s "$DIR/stats.c" -o "$TMP/off" || exit 1
+$CC -std=c99 -O2 -s "$TMP/bare/benchmarks/stats.c" -o "$TMP/bare/stats" || exit 1
+$CC -std=c99 -O2 -DHELP_HANDLER_STATS "$DIR/stats.c" -o "$TMP/on" || exit 1
+
+if cmp -s "$TMP/off" "$TMP/bare/stats"; then
+    echo "disabled build is identical to one without instrumentation ($(wc -c < "$TMP/off") bytes)"
+else
+    echo "disabled build differs from one without instrumentation" >&2
+    exit 1
+fi
+
+"$TMP/off" && "$TMP/on"
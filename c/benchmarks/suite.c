@@ -0,0 +1,184 @@
+/*
+ * Regression suite for the startup path: help_handler() and help_handler_f() across argc sizes, options, matched
+ * and unmatched argv and help file sizes. Reports ns, malloc calls (glibc only, through __libc_malloc wrappers,
+ * so regcomp's own allocations count too) and read/write syscalls per call (syscr/syscw from /proc/self/io)
+ *
+ * Output goes to /dev/null, so the write syscalls are real but the terminal isn't measured
+ *
+ * gcc -std=c99 -O2 suite.c -o suite && ./suite
+ */
+#define _POSIX_C_SOURCE 200809L
+#include "../help_handler.h"
+
+#include <time.h>
+
+
+
+
+static unsigned long long allocations = 0;
+
+#ifdef __GLIBC__
+#define COUNTS_ALLOCATIONS 1
+extern void* __libc_malloc(size_t size);
+extern void* __libc_calloc(size_t count, size_t size);
+extern void* __libc_realloc(void* p, size_t size);
+extern void  __libc_free(void* p);
+
+void* malloc(size_t size)               { allocations++; return __libc_malloc(size); }
+void* calloc(size_t count, size_t size) { allocations++; return __libc_calloc(count, size); }
+void* realloc(void* p, size_t size)     { allocations++; return __libc_realloc(p, size); }
+void  free(void* p)                     { __libc_free(p); }
+#else
+#define COUNTS_ALLOCATIONS 0
+#endif
+
+
+static long long syscalls(void) { /* -1 when /proc/self/io isn't there */
+    FILE* io = fopen("/proc/self/io", "r");
+    if (io == NULL) {
+        return -1; }
+
+    char line[128];
+    long long total = 0, value;
+    while (fgets(line, sizeof(line), io) != NULL) {
+        if (sscanf(line, "syscr: %lld", &value) == 1 || sscanf(line, "syscw: %lld", &value) == 1) {
+            total += value; }
+    }
+    fclose(io);
+    return total;
+}
+
+/* Last argument is --help when matched, so the whole argv is scanned */
+static char** make_argv(int argc, bool matched) {
+    char** argv = (char**)calloc((size_t)argc + 1, sizeof(char*));
+    argv[0] = "suite";
+    for (int i = 1; i < argc; i++) {
+        argv[i] = (char*)malloc(32);
+        snprintf(argv[i], 32, "--input=file%d", i); }
+    if (matched && argc > 1) {
+        strcpy(argv[argc-1], "--help"); }
+
+    return argv;
+}
+
+static void free_argv(int argc, char** argv) {
+    for (int i = 1; i < argc; i++) {
+        free(argv[i]); }
+    free(argv);
+}
+
+static double elapsed_ns(const struct timespec* start) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)(now.tv_sec - start->tv_sec) * 1e9 + (double)(now.tv_nsec - start->tv_nsec);
+}
+
+/* Runs in doubling batches until about 100ms have gone by, so slow cases still finish after a single call */
+static void measure(const char* label, int argc, char** argv, const char* help, const char* file) {
+    struct timespec start;
+    unsigned long long calls = 0;
+    double ns = 0;
+    fflush(stdout);
+    int err = dup(2);
+    int null = open("/dev/null", O_WRONLY);
+    dup2(null, 2);
+
+    unsigned long long allocs_before = allocations;
+    long long sys_before = syscalls();
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (unsigned long long batch = 1; ns < 1e8; batch *= 2) {
+        for (unsigned long long i = 0; i < batch; i++) {
+            if (file != NULL) {
+                help_handler_f(argc, argv, file);
+            } else {
+                help_handler(argc, argv, help); }
+        }
+        calls += batch;
+        ns = elapsed_ns(&start);
+    }
+    long long sys_after = syscalls();
+    unsigned long long allocs = allocations - allocs_before;
+
+    dup2(err, 2);
+    close(err);
+    close(null);
+
+    ns /= (double)calls;
+    char allocs_str[32] = "-", sys_str[32] = "-";
+    if (COUNTS_ALLOCATIONS) {
+        snprintf(allocs_str, sizeof(allocs_str), "%.2f", (double)allocs / (double)calls); }
+    if (sys_before >= 0) { /* Reading /proc/self/io takes two reads, counted once between the snapshots */
+        snprintf(sys_str, sizeof(sys_str), "%.2f", (double)(sys_after - sys_before - 2) / (double)calls); }
+    printf("%-52s %12.1f %10s %10s\n", label, ns, allocs_str, sys_str);
+}
+
+static void write_help_file(const char* path, size_t size) {
+    FILE* fp = fopen(path, "wb");
+    size_t written = (size_t)fprintf(fp, "usage: suite [options] <file>...\n");
+    while (written + 64 < size) {
+        written += (size_t)fprintf(fp, "  --option-%-8zu does something worth a line of help............\n", written); }
+    while (written + 1 < size) {
+        fputc('.', fp);
+        written++; }
+    fputc('\n', fp);
+    fclose(fp);
+}
+
+
+
+
+int main(void) {
+    const char* help = "usage: suite [options] <file>...\n  -h, --help     show this text\n  -v, --version  show the version\n";
+    const int sizes[] = { 1, 10, 256, 10000, 100000 };
+    const char* files[] = { "/tmp/help_handler_suite_small.txt", "/tmp/help_handler_suite_large.txt" };
+    const char* file_labels[] = { "256B", "1MiB" };
+    char label[128];
+
+    write_help_file(files[0], 256);
+    write_help_file(files[1], 1 << 20);
+
+    help_handler_info("suite", "1.0");
+    int dev_null = open("/dev/null", O_WRONLY);
+    help_handler_sink_fd(dev_null);
+
+    printf("%-52s %12s %10s %10s\n", "case", "ns/call", "allocs", "syscalls");
+    for (int extra = 1; extra >= 0; extra--) {
+        for (int unknown = 0; unknown <= 1; unknown++) {
+            help_handler_config(extra == 1, true, unknown == 1);
+
+            for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+                for (int matched = 1; matched >= 0; matched--) {
+                    int argc = sizes[s];
+                    if (argc == 1 && matched == 0) { continue; } /* argc 1 is the no argument help either way */
+
+                    char** argv = make_argv(argc, matched);
+                    snprintf(label, sizeof(label), "help_handler extra=%d unknown=%d argc=%-6d %s",
+                             extra, unknown, argc, matched ? "matched" : "unmatched");
+                    measure(label, argc, argv, help, NULL);
+                    free_argv(argc, argv);
+                }
+            }
+        }
+    }
+
+    help_handler_config(true, true, false);
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        for (int matched = 1; matched >= 0; matched--) {
+            int argc = sizes[s];
+            if (argc == 1 && matched == 0) { continue; }
+
+            char** argv = make_argv(argc, matched);
+            for (int f = 0; f < 2; f++) {
+                snprintf(label, sizeof(label), "help_handler_f %s argc=%-6d %s",
+                         file_labels[f], argc, matched ? "matched" : "unmatched");
+                measure(label, argc, argv, NULL, files[f]);
+            }
+            free_argv(argc, argv);
+        }
+    }
+
+    close(dev_null);
+    remove(files[0]);
+    remove(files[1]);
+    return EXIT_SUCCESS;
+}
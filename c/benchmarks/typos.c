@@ -0,0 +1,67 @@
+/*
+ * Per-argument cost of typo matching on top of the pattern match. Arguments are ordinary options and operands more
+ * than 3 edits from both keywords, so every one goes through the whole path. Build it both ways to
+ * compare against the regex path and the hand-written matcher:
+ *
+ * gcc -std=c99 -O2 typos.c -o typos && ./typos
+ * gcc -std=c99 -O2 -DHELP_HANDLER_NO_REGEX typos.c -o typos && ./typos
+ */
+#define _POSIX_C_SOURCE 200809L
+#include "../help_handler.h"
+
+#include <time.h>
+
+
+
+
+#define ARGUMENTS 1000
+
+static char buffer[1 << 12];
+static size_t length = 0;
+
+static double ns_per_argument(int argc, char** argv) {
+    struct timespec start, now;
+    unsigned long long calls = 0;
+    double ns = 0;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (unsigned long long batch = 1; ns < 2e8; batch *= 2) {
+        for (unsigned long long i = 0; i < batch; i++) {
+            length = 0;
+            help_handler(argc, argv, "usage: typos"); }
+        calls += batch;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        ns = (double)(now.tv_sec - start.tv_sec) * 1e9 + (double)(now.tv_nsec - start.tv_nsec);
+    }
+
+    return ns / (double)calls / (double)(argc - 1);
+}
+
+int main(void) {
+    const char* samples[] = { "--input=file.txt", "-o", "out.bin", "--jobs=8", "build", "-x", "--quiet",
+                              "--dry-run", "--force", "--tag", "--release", "src/main.c", "--config", "-j4" };
+    char* argv[ARGUMENTS + 1] = { "typos" };
+    for (int i = 1; i <= ARGUMENTS; i++) {
+        argv[i] = (char*)samples[i % (sizeof(samples) / sizeof(samples[0]))]; }
+
+    help_handler_sink_buffer(buffer, sizeof(buffer), &length);
+    help_handler_config(true, false, false);
+
+    #ifdef HELP_HANDLER_NO_REGEX
+    const char* matcher = "hand-written";
+    #else
+    const char* matcher = "regex";
+    #endif
+    double base = 0;
+    for (unsigned int distance = 0; distance <= 2; distance++) {
+        help_handler_typos(distance);
+        double ns = ns_per_argument(ARGUMENTS + 1, argv);
+        if (distance == 0) {
+            base = ns; }
+        if (length != 0) {
+            printf("an argument matched, so the numbers below are off\n"); }
+        printf("%s, typos %u %8.2f ns/argument (typo matching %+.2f)\n", matcher, distance, ns, ns - base);
+    }
+
+    return EXIT_SUCCESS;
+}
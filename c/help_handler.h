@@ -41,6 +41,11 @@
 #define HELP_HANDLER_DISABLE_UNKNOWN_ARGS false
 #define HELP_HANDLER_DISABLE_EXTRA_STRINGS false
 
+//Passable to help_handler_sources(), or'd together
+#define HELP_HANDLER_RESPONSE_FILES 1u
+#define HELP_HANDLER_STDIN_LINES 2u
+#define HELP_HANDLER_STDIN_NUL 4u
+
 //Return values
 static const int helpHandlerSuccess = 0; //This should remain 0, as it's also used to indicate no arguments were matched
 static const int helpHandlerFailure = -1;
@@ -89,10 +94,10 @@ static const int helpHandlerFailure = -1;
                                 const wchar_t*: help_handler_name_w, \
                                 default: help_handler_name_s) \
                         (app_name)
-#define help_handler_pipe(outputPipe) _Generic(outputPipe, \
+#define help_handler_pipe(output_pipe) _Generic(output_pipe, \
                                 int: help_handler_pipe_i, \
                                 default: help_handler_pipe_s) \
-                        (outputPipe)
+                        (output_pipe)
 #endif
 
 
@@ -111,25 +116,59 @@ static const int helpHandlerFailure = -1;
     #include <unistd.h>
     #if defined(_POSIX_VERSION) //POSIX compliant
         #define HELP_HANDLER_POSIX_C
-        #include <regex.h>
+        #include <fcntl.h>
+        #include <sys/uio.h>
+        #include <sys/mman.h>
+        #include <sys/stat.h>
     #endif
 #elif defined(__CYGWIN__) && !defined(_WIN32) //Windows with Cygwin (POSIX)
     #define HELP_HANDLER_POSIX_C
-    #include <regex.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+    #include <sys/uio.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
 #elif defined(_WIN64) || defined(_WIN32) //Windows
 #include <windows.h>
-#else
-    //MSVC is the only common compiler that doesn't support the warning directive
-    #if _MSC_VER && !__INTEL_COMPILER //Prefixing "warning:" makes MSVC output a warning instead of a message
-        #pragma message("warning: Compiling without regular expression support") 
-    #else
-        #warning "Compiling without regular expression support"
+#include <io.h>
+#endif
+
+//Anything without regex.h, or built with HELP_HANDLER_NO_REGEX, matches arguments by hand instead, accepting exactly
+//what the regexes would. glibc's regexec() allocates on every call, so this is the way to keep help_handler malloc free
+#if defined(HELP_HANDLER_POSIX_C) && !defined(HELP_HANDLER_NO_REGEX)
+    #define HELP_HANDLER_REGEX_C
+    #include <regex.h>
+#endif
+
+//The argument prefilter searches 16 bytes at a time with SSE2 (always there on x86-64) and 32 with AVX2 when the CPU
+//has it, chosen at run time. Other targets and compilers get the byte at a time loop
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__)) && defined(__SSE2__)
+    #define HELP_HANDLER_SSE2_C
+    #include <immintrin.h>
+    #if defined(__clang__) || __GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9) //target("avx2") and __builtin_cpu_supports
+        #define HELP_HANDLER_AVX2_C
     #endif
 #endif
 
+//Opt-in instrumentation, none of which is compiled in unless asked for. HELP_HANDLER_STATS keeps per-phase counters
+//and timers for help_handler_get_stats(), HELP_HANDLER_PROBES adds USDT probes (provider help_handler) for bpftrace/perf
+#ifdef HELP_HANDLER_STATS
+    #include <time.h>
+#endif
+#ifdef HELP_HANDLER_PROBES
+    #include <sys/sdt.h> //systemtap-sdt-dev on Debian/Ubuntu, systemtap-sdt-devel on Fedora
+#endif
+
 
 #define MAX_STRING_LEN 64
 #define MAX_STRING_COUNT 32
+#define MAX_FRAGMENTS 16
+#define MAX_SCRATCH_LEN 512
+#define MAX_RENDER_LEN 2048
+#define MAX_TYPO_DISTANCE 2 //Version's bound, help's is 1
+#define SOURCE_BUFFER_LEN 65536
+#define MAX_SOURCE_DEPTH 8
+#define MAX_TOPIC_LEN 256
 
 
 static bool   printErr = true;
@@ -137,7 +176,6 @@ static size_t errCount = 0; //Used for counting & printing ALL errors when user
 static char   errs[MAX_STRING_COUNT][MAX_STRING_LEN] = {{0}};
 
 static const char* helpHandlerFuncName = "help_handler";
-static int outputPipe = 0; //Used by print_pipe()
 
 /*
  * These enums below are used for verbosity/changeability internally, in place of what'd otherwise be magic numbers
@@ -154,13 +192,48 @@ enum varTypes {
     versionInt,
     versionDouble, };
 enum returnVal {
-    dialogHelpVer = 0,
+    dialogNone = 0, //Must remain 0, as it doubles as helpHandlerSuccess
+    dialogHelpVer,
     dialogHelp,
-    dialogVer, };
+    dialogVer,
+    dialogNoArgs, }; //Internal only, never returned to the user
 enum errTypes {
     silent = 0,
     warning,
     error, };
+enum sinkTypes {
+    sinkFd = 0,
+    sinkFile,
+    sinkBuffer,
+    sinkCallback, };
+
+//Output is gathered as fragments and handed to the sink in one go (a single writev() for fd sinks)
+struct help_handler_fragment {
+    const char* data;
+    size_t size;
+};
+typedef void (*help_handler_callback)(const struct help_handler_fragment* fragments, size_t count, void* context);
+//A help provider is only called once the help dialogue is going to be printed, and may call write any number of times
+typedef void (*help_handler_writer)(const char* data, size_t size);
+typedef void (*help_handler_provider)(help_handler_writer write, void* context);
+
+static struct sink_t {
+    int type;
+    int fd;
+    FILE* file;
+    char* buffer;
+    size_t capacity;
+    size_t* length;
+    help_handler_callback callback;
+    void* context;
+} sink_t = { sinkFd, 1, NULL, NULL, 0, NULL, NULL, NULL }; //fd 1 is stdout
+
+static struct out_t {
+    struct help_handler_fragment fragments[MAX_FRAGMENTS];
+    size_t count;
+    char scratch[MAX_SCRATCH_LEN]; //Backing storage for numbers and converted wide strings until the next flush
+    size_t scratch_len;
+} out_t;
 
 //User info structs
 static struct most_recent_t {
@@ -174,13 +247,78 @@ static struct info_t {
     char ver_str[512];
     unsigned int ver_int;
     double ver_double;
-} info_t = { {0}, {0}, "No version is available", 0, 0 };
+    const char* noted_help; //The help text HELP_HANDLER_NOTE embedded, if it was used
+} info_t = { {0}, {0}, "No version is available", 0, 0, NULL };
+
+//Response heads, rendered whenever the name or version changes so help_handler only has to append the help text
+static struct render_t {
+    char help_head[MAX_RENDER_LEN];     //"name "
+    size_t help_head_len;
+    char ver_only[MAX_RENDER_LEN];      //"version\n"
+    size_t ver_only_len;
+    char help_ver_head[MAX_RENDER_LEN]; //"name Version version\n"
+    size_t help_ver_head_len;
+} render_t = { "", 0, "No version is available\n", 24, "No version is available\n", 24 };
 
 static struct options_t {
     bool no_arg_help;
     bool extra_strings;
     bool unknown_arg_help;
-} options_t = { true, true, false }; 
+    unsigned int typo_distance; //Edits tolerated by typo matching, 0 turns it off
+    unsigned int sources;       //HELP_HANDLER_RESPONSE_FILES/STDIN_* bits, where arguments are read from besides argv
+} options_t = { true, true, false, 0, 0 }; 
+
+//Totals since start up or the last help_handler_reset_stats()
+struct help_handler_stats {
+    unsigned long long calls;         //help_handler calls of any kind
+    unsigned long long args_scanned;  //Arguments matched against before each call stopped
+    unsigned long long match_ns;      //Time spent matching them
+    unsigned long long compiles;      //Regex compiles, which only happen on first use and after extra_strings changes
+    unsigned long long compile_ns;
+    unsigned long long file_loads;    //Help files opened by help_handler_f
+    unsigned long long file_bytes;
+    unsigned long long file_ns;       //Opening and mapping them (opening and the first read where there's no mmap)
+    unsigned long long writes;        //Sink writes, each a single writev() or flush
+    unsigned long long bytes_written;
+    unsigned long long write_ns;
+};
+
+#ifdef HELP_HANDLER_STATS
+static struct help_handler_stats stats_t;
+
+static unsigned long long stats_now(void) {
+    #if defined(CLOCK_MONOTONIC) //Only declared with _POSIX_C_SOURCE or similar
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long long)ts.tv_sec * 1000000000ULL + (unsigned long long)ts.tv_nsec;
+    #elif defined(TIME_UTC) //C11
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (unsigned long long)ts.tv_sec * 1000000000ULL + (unsigned long long)ts.tv_nsec;
+    #else
+    return (unsigned long long)clock() * (1000000000ULL / CLOCKS_PER_SEC);
+    #endif
+}
+
+    #define HELP_HANDLER_STAT_ADD(counter, n) (stats_t.counter += (unsigned long long)(n))
+    #define HELP_HANDLER_STAT_START(timer) unsigned long long timer = stats_now()
+    #define HELP_HANDLER_STAT_TIME(counter, timer) (stats_t.counter += stats_now() - (timer))
+#else
+    //Arguments aren't evaluated, so a disabled build doesn't even compute what would have been counted
+    #define HELP_HANDLER_STAT_ADD(counter, n) ((void)0)
+    #define HELP_HANDLER_STAT_START(timer) ((void)0)
+    #define HELP_HANDLER_STAT_TIME(counter, timer) ((void)0)
+#endif
+
+#ifdef HELP_HANDLER_PROBES
+    #define HELP_HANDLER_PROBE(name) DTRACE_PROBE(help_handler, name)
+    #define HELP_HANDLER_PROBE1(name, a) DTRACE_PROBE1(help_handler, name, a)
+    #define HELP_HANDLER_PROBE2(name, a, b) DTRACE_PROBE2(help_handler, name, a, b)
+#else
+    #define HELP_HANDLER_PROBE(name) ((void)0)
+    #define HELP_HANDLER_PROBE1(name, a) ((void)0)
+    #define HELP_HANDLER_PROBE2(name, a, b) ((void)0)
+#endif
 
 
 bool help_handler_is_err(int errorCode); //Forward declaration so private functions can use this to check for errors
@@ -196,41 +334,134 @@ bool help_handler_is_err(int errorCode); //Forward declaration so private functi
 /*
  * String functions
  */
-//While making print_pipe take varargs would obviate calling print_pipe repeatedly, it would also cause string-nonliteral warnings (surpressing these would require non-portable macros)
-static void print_pipe(const char* s) {
-    if (outputPipe == outDefault) {
-        fprintf(stdout, "%s", s);
-        fflush(stdout);
-    } else if (outputPipe == outStdout) {
-        fprintf(stdout, "%s", s);
-        fflush(stdout);
-    } else if (outputPipe == outStderr) {
-        fprintf(stderr, "%s", s);
-        fflush(stderr); //stderr isn't buffered by default, but flush just in case
+//Fragments must stay valid until flush_pipe(), which every caller does before its buffers go out of scope
+static void write_fd(const struct help_handler_fragment* fragments, size_t count) {
+    //Anything the program already put through stdio has to go out first to keep ordering
+    if (sink_t.fd == 1) {
+        fflush(stdout); }
+
+    #ifdef HELP_HANDLER_POSIX_C
+    struct iovec iov[MAX_FRAGMENTS];
+    int n = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (fragments[i].size == 0) { continue; }
+        iov[n].iov_base = (void*)fragments[i].data; //Cast away const, writev doesn't modify it
+        iov[n].iov_len  = fragments[i].size;
+        n++; }
+
+    struct iovec* next = iov;
+    while (n > 0) {
+        ssize_t written = writev(sink_t.fd, next, n);
+        if (written < 0) {
+            if (errno == EINTR) { continue; }
+            return; } //Nowhere left to report a failed write to
+
+        //Partial write, skip past whatever made it out and go again
+        while (n > 0 && (size_t)written >= next->iov_len) {
+            written -= (ssize_t)next->iov_len;
+            next++;
+            n--; }
+        if (n > 0) {
+            next->iov_base = (char*)next->iov_base + written;
+            next->iov_len -= (size_t)written; }
     }
+    #else
+    for (size_t i = 0; i < count; i++) {
+        const char* data = fragments[i].data;
+        size_t left = fragments[i].size;
+        while (left > 0) {
+            #if defined _WIN32 || defined _WIN64
+            int written = _write(sink_t.fd, data, (unsigned int)left);
+            #else
+            int written = (int)fwrite(data, 1, left, sink_t.fd == 2 ? stderr : stdout);
+            #endif
+            if (written <= 0) { return; }
+            data += written;
+            left -= (size_t)written; }
+    }
+    #if !defined _WIN32 && !defined _WIN64
+    fflush(sink_t.fd == 2 ? stderr : stdout);
+    #endif
+    #endif
+}
+
+#if defined(HELP_HANDLER_STATS) || defined(HELP_HANDLER_PROBES)
+static size_t fragment_bytes(void) { //Only used by the instrumentation
+    size_t total = 0;
+    for (size_t i = 0; i < out_t.count; i++) {
+        total += out_t.fragments[i].size; }
+    return total;
+}
+#endif
+
+static void flush_pipe(void) {
+    if (out_t.count == 0) {
+        return; }
+    HELP_HANDLER_PROBE2(write_start, fragment_bytes(), out_t.count);
+    HELP_HANDLER_STAT_START(start);
+
+    if (sink_t.type == sinkFd) {
+        write_fd(out_t.fragments, out_t.count);
+    } else if (sink_t.type == sinkFile) {
+        for (size_t i = 0; i < out_t.count; i++) {
+            fwrite(out_t.fragments[i].data, 1, out_t.fragments[i].size, sink_t.file); }
+        fflush(sink_t.file);
+    } else if (sink_t.type == sinkBuffer) { //Appends, truncating to capacity. length keeps the untruncated total
+        for (size_t i = 0; i < out_t.count; i++) {
+            size_t room = *sink_t.length < sink_t.capacity ? sink_t.capacity - *sink_t.length : 0;
+            if (room > 0) { //Past capacity, buffer + *length would point past the end
+                memcpy(sink_t.buffer + *sink_t.length, out_t.fragments[i].data, out_t.fragments[i].size < room ? out_t.fragments[i].size : room); }
+            *sink_t.length += out_t.fragments[i].size; }
+    } else if (sink_t.type == sinkCallback && sink_t.callback != NULL) {
+        sink_t.callback(out_t.fragments, out_t.count, sink_t.context); }
+    HELP_HANDLER_STAT_TIME(write_ns, start);
+    HELP_HANDLER_STAT_ADD(writes, 1);
+    HELP_HANDLER_STAT_ADD(bytes_written, fragment_bytes());
+    HELP_HANDLER_PROBE(write_done);
+
+    out_t.count = 0;
+    out_t.scratch_len = 0;
+}
+
+static void print_pipe_n(const char* s, size_t n) {
+    if (n == 0) {
+        return; }
+    if (out_t.count == MAX_FRAGMENTS) {
+        flush_pipe(); }
+
+    out_t.fragments[out_t.count].data = s;
+    out_t.fragments[out_t.count].size = n;
+    out_t.count++;
+}
+static void print_pipe(const char* s) {
+    print_pipe_n(s, strlen(s));
+}
+static char* scratch_reserve(size_t n) { //n must be at most MAX_SCRATCH_LEN
+    if (out_t.scratch_len + n > MAX_SCRATCH_LEN) {
+        flush_pipe(); }
+
+    return out_t.scratch + out_t.scratch_len;
 }
 static void print_pipe_i(int n) {
-    if (outputPipe == outDefault) {
-        fprintf(stdout, "%d", n);
-        fflush(stdout);
-    } else if (outputPipe == outStdout) {
-        fprintf(stdout, "%d", n);
-        fflush(stdout);
-    } else if (outputPipe == outStderr) {
-        fprintf(stderr, "%d", n);
-        fflush(stderr); //stderr isn't buffered by default, but flush just in case
-    }
+    char* s = scratch_reserve(MAX_STRING_LEN);
+    int len = snprintf(s, MAX_STRING_LEN, "%d", n);
+    out_t.scratch_len += (size_t)len;
+    print_pipe_n(s, (size_t)len);
 }
-static void print_pipe_w(const wchar_t* s) {
-    if (outputPipe == outDefault) {
-        fwprintf(stdout, L"%ls", s);
-        fflush(stdout);
-    } else if (outputPipe == outStdout) {
-        fwprintf(stdout, L"%ls", s);
-        fflush(stdout);
-    } else if (outputPipe == outStderr) {
-        fwprintf(stderr, L"%ls", s);
-        fflush(stderr); //stderr isn't buffered by default, but flush just in case
+static void print_pipe_w(const wchar_t* s) { //Converted to multibyte through the scratch buffer in the current locale, as fwprintf would
+    mbstate_t state;
+    memset(&state, 0, sizeof(state));
+
+    while (s != NULL) {
+        char* dst = scratch_reserve(MAX_SCRATCH_LEN/2);
+        size_t len = wcsrtombs(dst, &s, MAX_SCRATCH_LEN/2, &state);
+        if (len == (size_t)-1) {
+            break; } //Unrepresentable character, stop there
+
+        out_t.scratch_len += len;
+        print_pipe_n(dst, len);
+        if (s != NULL) { //Scratch filled up before the end of the string
+            flush_pipe(); }
     }
 }
 
@@ -265,6 +496,7 @@ static void print_err(const char* s, int err_line, int err_val) {
         }
 
         print_pipe("\n");
+        flush_pipe();
     }
     #endif
 
@@ -272,7 +504,7 @@ static void print_err(const char* s, int err_line, int err_val) {
 }
 
 static int string_check(const char* s, int s_line, int err_val, const char* var_name) {
-    char err_msg[MAX_STRING_LEN];
+    char err_msg[MAX_STRING_LEN] = "string";
 
     if (var_name != NULL) {
         strcpy(err_msg, var_name); }
@@ -281,14 +513,14 @@ static int string_check(const char* s, int s_line, int err_val, const char* var_
         print_err(err_msg, s_line,  err_val);
         return EXIT_FAILURE; }
     if (s[0] == '\0') {
-        strcat(err_msg, "is empty");
+        strcat(err_msg, " is empty");
         print_err(err_msg, s_line,  err_val);
         return EXIT_FAILURE; } 
 
     return EXIT_SUCCESS;
 }
 static int string_check_w(const wchar_t* s, int s_line, int err_val, const char* var_name) {
-    char err_msg[MAX_STRING_LEN];
+    char err_msg[MAX_STRING_LEN] = "string";
 
     if (var_name != NULL) {
         strcpy(err_msg, var_name); }
@@ -297,12 +529,9 @@ static int string_check_w(const wchar_t* s, int s_line, int err_val, const char*
         print_err(err_msg, s_line,  err_val);
         return EXIT_FAILURE; }
     if (s[0] == L'\0') {
-            strcat(err_msg, "is empty");
-            print_err(err_msg, s_line,  err_val);
-            return EXIT_FAILURE; }
-    else if (sizeof(wchar_t) == 4) {
-
-    }
+        strcat(err_msg, " is empty");
+        print_err(err_msg, s_line,  err_val);
+        return EXIT_FAILURE; }
 
     return EXIT_SUCCESS;
 }
@@ -310,42 +539,67 @@ static int string_check_w(const wchar_t* s, int s_line, int err_val, const char*
 /*
  * Utilities
  */
-#ifdef HELP_HANDLER_POSIX_C
-static int regex_match(const char *s, const char *pattern) {
-    regex_t reg;
-    if (regcomp(&reg, pattern, REG_EXTENDED|REG_ICASE|REG_NOSUB) != 0) {
-        print_err("failed to compile regex", __LINE__, error);
-        return EXIT_FAILURE; }
+#ifdef HELP_HANDLER_REGEX_C
+//Compiled for the current extra_strings setting on first use, and again only after help_handler_config() changes it
+static struct lex_t {
+    regex_t help;
+    regex_t ver;
+    bool compiled;
+    bool extra_strings;
+} lex_t;
 
-    int status = regexec(&reg, s, 0, NULL, 0);
-    regfree(&reg);
+static void lex_free(void) {
+    if (lex_t.compiled == true) {
+        regfree(&lex_t.help);
+        regfree(&lex_t.ver);
+        lex_t.compiled = false; }
+}
+
+static int lex_compile(void) {
+    if (lex_t.compiled == true && lex_t.extra_strings == options_t.extra_strings) {
+        return EXIT_SUCCESS; }
+    lex_free();
+    HELP_HANDLER_PROBE(compile_start);
+    HELP_HANDLER_STAT_START(start);
+
+    const char* help_lex;
+    const char* ver_lex;
+    if (options_t.extra_strings == true) {
+        help_lex = "-{0,}h{1,}e{1,}l{1,}p{1,}(.*)|-{0,}h{1,}$";
+        ver_lex  = "-{0,}v{1,}e{1,}r{1,}s{0,}i{0,}o{0,}n{0,}(.*)|^-{0,}v$";
+    } else {
+        help_lex = "-{0,}h{1,}e{1,}l{1,}p{1,}(.*)";
+        ver_lex  = "-{0,}v{1,}e{1,}r{1,}s{0,}i{0,}o{0,}n{0,}(.*)"; }
 
-    if (status != 0) {
+    if (regcomp(&lex_t.help, help_lex, REG_EXTENDED|REG_ICASE|REG_NOSUB) != 0) {
+        print_err("failed to compile regex", __LINE__, error);
+        return EXIT_FAILURE; }
+    if (regcomp(&lex_t.ver, ver_lex, REG_EXTENDED|REG_ICASE|REG_NOSUB) != 0) {
+        regfree(&lex_t.help);
+        print_err("failed to compile regex", __LINE__, error);
         return EXIT_FAILURE; }
 
+    lex_t.compiled      = true;
+    lex_t.extra_strings = options_t.extra_strings;
+    HELP_HANDLER_STAT_TIME(compile_ns, start);
+    HELP_HANDLER_STAT_ADD(compiles, 1);
+    HELP_HANDLER_PROBE(compile_done);
     return EXIT_SUCCESS;
 }
 #endif
 
+//Copies str without its surrounding whitespace into out, truncated to fit len
 static size_t trim(char *out, size_t len, const char *str) {
     const char* end;
     size_t out_size;
 
-    
-    //Trim leading whitespace
-    while(isspace((unsigned char)*str)) { str++; };
-    //Trim trailing space
-    end = str + strlen(str) - 1;
-    while(isspace((unsigned char)*end)) { end--; };
-    end++;
+    while (isspace((unsigned char)*str)) { str++; }
+    end = str + strlen(str);
+    while (end > str && isspace((unsigned char)end[-1])) { end--; }
 
-    //Set output size to minimum of trimmed string length and buffer size minus 1
-    out_size = (end-str) < (unsigned int)len-1 ? (unsigned int)(end-str) : len-1;
-
-    // Copy trimmed string and add null terminator
+    out_size = (size_t)(end - str) < len - 1 ? (size_t)(end - str) : len - 1;
     memcpy(out, str, out_size);
-    out[out_size] = 0;
-
+    out[out_size] = '\0';
 
     return out_size;
 }
@@ -357,43 +611,536 @@ int return_result(int result_help, int result_ver) {
     if (result_help > 0 && result_ver > 0) { return dialogHelpVer; }
     else if (result_help > 0) { return dialogHelp;
     } else if (result_ver > 0) { return dialogVer;
-    } else if (result_help == 0 && result_ver == 0) { return 0;
-    } else { return 0; }
-}
-
-static bool print_ver(void) {
-    if (most_recent_t.ver == versionStr) {
-        print_pipe(info_t.ver_str);
-        return true;
-    } else if (most_recent_t.ver == versionInt) {
-        char n[MAX_STRING_LEN];
-        sprintf(n, "%d", info_t.ver_int);
-        print_pipe(n);
-        return true;
+    } else { return dialogNone; }
+}
+
+static size_t render_clamp(int len, size_t size) {
+    if (len < 0) { return 0; }
+    return (size_t)len < size ? (size_t)len : size-1;
+}
+
+static void render(void) {
+    char ver[MAX_STRING_LEN > sizeof(info_t.ver_str) ? MAX_STRING_LEN : sizeof(info_t.ver_str)];
+    char name[MAX_RENDER_LEN/2];
+    bool has_name = false;
+
+    if (most_recent_t.ver == versionInt) {
+        snprintf(ver, sizeof(ver), "%u", info_t.ver_int);
     } else if (most_recent_t.ver == versionDouble) {
-        char n[MAX_STRING_LEN];
-        sprintf(n, "%lf", info_t.ver_double);
-        print_pipe(n);
-        return true; }
+        snprintf(ver, sizeof(ver), "%lf", info_t.ver_double);
+    } else {
+        strcpy(ver, info_t.ver_str); }
+
+    name[0] = '\0';
+    if (strlen(info_t.name) > 0 && most_recent_t.name == nameChar) {
+        strcpy(name, info_t.name);
+        has_name = true;
+    } else if (wcslen(info_t.name_w) > 0 && most_recent_t.name == nameWChar) { //Converted in the locale current at the time it's set
+        if (wcstombs(name, info_t.name_w, sizeof(name)-1) == (size_t)-1) {
+            name[0] = '\0'; }
+        name[sizeof(name)-1] = '\0';
+        has_name = true; }
+
+    if (has_name) {
+        render_t.help_head_len     = render_clamp(snprintf(render_t.help_head, MAX_RENDER_LEN, "%s ", name), MAX_RENDER_LEN);
+        render_t.help_ver_head_len = render_clamp(snprintf(render_t.help_ver_head, MAX_RENDER_LEN, "%s Version %s\n", name, ver), MAX_RENDER_LEN);
+    } else {
+        render_t.help_head[0] = '\0';
+        render_t.help_head_len     = 0;
+        render_t.help_ver_head_len = render_clamp(snprintf(render_t.help_ver_head, MAX_RENDER_LEN, "%s\n", ver), MAX_RENDER_LEN); }
+    render_t.ver_only_len = render_clamp(snprintf(render_t.ver_only, MAX_RENDER_LEN, "%s\n", ver), MAX_RENDER_LEN);
+}
+
+
+/*
+ * Without regex.h, arguments are matched by hand against the same set the POSIX patterns accept. regexec searches
+ * for a match anywhere in the argument, so:
+ *   help    contains "he+l+p", or with extra_strings ends in "h"
+ *   version contains "ve+r",  or with extra_strings is exactly "-*v"
+ * case insensitively. Each check is one pass over the argument. Compiled with the regexes too, where being inline and
+ * unused costs nothing, so tests/matcher.c can check the two against each other in one binary
+ */
+//Whether s contains word, with every letter but the first and last allowed to repeat ("he+l+p" for "help")
+static inline bool lex_contains(const char* s, const char* word, size_t len) {
+    size_t matched = 0; //Letters of word matched so far. Its letters are all different, so a mismatch can only restart it
+    for (; *s != '\0'; s++) {
+        char c = (char)tolower((unsigned char)*s);
+        if (matched >= 2 && c == word[matched-1]) {
+            continue; }
+
+        if (c == word[matched]) {
+            matched++;
+            if (matched == len) {
+                return true; }
+        } else {
+            matched = c == word[0] ? 1 : 0; }
+    }
 
     return false;
 }
 
-static bool print_name(void) {
-    if (strlen(info_t.name) > 0 && most_recent_t.name == nameChar) {
-        print_pipe(info_t.name);
-        return true;
-    } else if (wcslen(info_t.name_w) > 0 && most_recent_t.name == nameWChar) {
-        print_pipe_w(info_t.name_w);
+static inline bool hand_is_help(const char* arg) {
+    if (lex_contains(arg, "help", 4)) {
+        return true; }
+
+    size_t len = strlen(arg);
+    return options_t.extra_strings == true && len > 0 && tolower((unsigned char)arg[len-1]) == 'h';
+}
+
+static inline bool hand_is_ver(const char* arg) {
+    if (lex_contains(arg, "ver", 3)) {
         return true; }
+    if (options_t.extra_strings != true) {
+        return false; }
+
+    while (*arg == '-') { arg++; }
+    return tolower((unsigned char)arg[0]) == 'v' && arg[1] == '\0';
+}
+
+static bool arg_is_help(const char* arg) {
+    #ifdef HELP_HANDLER_REGEX_C
+    return regexec(&lex_t.help, arg, 0, NULL, 0) == 0;
+    #else
+    return hand_is_help(arg);
+    #endif
+}
+
+static bool arg_is_ver(const char* arg) {
+    #ifdef HELP_HANDLER_REGEX_C
+    return regexec(&lex_t.ver, arg, 0, NULL, 0) == 0;
+    #else
+    return hand_is_ver(arg);
+    #endif
+}
+
+/*
+ * Prefilter, run on every argument before the patterns. Both only ever match an argument containing "he" (help) or
+ * "ve" (version) case insensitively, or with extra_strings one ending in h or v, so everything else (nearly every
+ * path, ID and value in a long argv) is turned away without calling regexec(). It only ever says maybe: what it lets
+ * through is still matched in full, so exactly the same arguments match as without it
+ */
+static const unsigned int prefilterHelp = 1;
+static const unsigned int prefilterVer  = 2;
+
+//Checks the digrams starting at arg[at..len-1), from where the vector loops below stopped
+static unsigned int digrams_scalar(const char* arg, size_t len, size_t at, unsigned int found) {
+    for (size_t i = at; i + 1 < len && found != (prefilterHelp|prefilterVer); i++) {
+        if ((arg[i+1] | 0x20) == 'e') { //| 0x20 lowercases letters, and only 'E'/'e' end up as 'e'
+            const char c = (char)(arg[i] | 0x20);
+            found |= c == 'h' ? prefilterHelp : c == 'v' ? prefilterVer : 0; }
+    }
+    return found;
+}
+
+#ifdef HELP_HANDLER_SSE2_C
+//Each pass compares 16 bytes and the 16 after each of them, so it never reads past arg[len-1]
+static unsigned int digrams_sse2(const char* arg, size_t len, size_t* at, unsigned int found) {
+    const __m128i lower = _mm_set1_epi8(0x20), h = _mm_set1_epi8('h'), v = _mm_set1_epi8('v'), e = _mm_set1_epi8('e');
+    size_t i = *at;
+    for (; i + 17 <= len && found != (prefilterHelp|prefilterVer); i += 16) {
+        const __m128i first  = _mm_or_si128(_mm_loadu_si128((const __m128i*)(arg + i)), lower);
+        const __m128i second = _mm_cmpeq_epi8(_mm_or_si128(_mm_loadu_si128((const __m128i*)(arg + i + 1)), lower), e);
+        found |= _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(first, h), second)) != 0 ? prefilterHelp : 0;
+        found |= _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(first, v), second)) != 0 ? prefilterVer : 0;
+    }
+    *at = i;
+    return found;
+}
+#endif
+
+#ifdef HELP_HANDLER_AVX2_C
+__attribute__((target("avx2")))
+static unsigned int digrams_avx2(const char* arg, size_t len, size_t* at, unsigned int found) {
+    const __m256i lower = _mm256_set1_epi8(0x20), h = _mm256_set1_epi8('h'), v = _mm256_set1_epi8('v'), e = _mm256_set1_epi8('e');
+    size_t i = *at;
+    for (; i + 33 <= len && found != (prefilterHelp|prefilterVer); i += 32) {
+        const __m256i first  = _mm256_or_si256(_mm256_loadu_si256((const __m256i*)(arg + i)), lower);
+        const __m256i second = _mm256_cmpeq_epi8(_mm256_or_si256(_mm256_loadu_si256((const __m256i*)(arg + i + 1)), lower), e);
+        found |= _mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(first, h), second)) != 0 ? prefilterHelp : 0;
+        found |= _mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(first, v), second)) != 0 ? prefilterVer : 0;
+    }
+    *at = i;
+    return found;
+}
+#endif
+
+//Which patterns could match arg, as prefilterHelp/prefilterVer bits
+static unsigned int arg_prefilter(const char* arg) {
+    const size_t len = strlen(arg);
+    unsigned int found = 0;
+    if (len == 0) {
+        return 0; }
+    if (options_t.extra_strings == true) {
+        const char last = (char)(arg[len-1] | 0x20);
+        found |= last == 'h' ? prefilterHelp : last == 'v' ? prefilterVer : 0; }
+
+    size_t at = 0;
+    #ifdef HELP_HANDLER_AVX2_C
+    if (len >= 33 && __builtin_cpu_supports("avx2")) {
+        found = digrams_avx2(arg, len, &at, found); }
+    #endif
+    #ifdef HELP_HANDLER_SSE2_C
+    found = digrams_sse2(arg, len, &at, found);
+    #endif
+    return digrams_scalar(arg, len, at, found);
+}
+
+/*
+ * Typo matching, opt-in through help_handler_typos() and only tried on arguments neither pattern matched that start
+ * with a dash. The argument without its leading dashes is compared against "help" and "version" by optimal string
+ * alignment distance (Levenshtein plus swapping two adjacent letters, so --hlep and --verison are one edit away), case
+ * insensitively. Hyyrö's bit-parallel algorithm keeps a whole column of the distance table in one word, so each
+ * character costs a few word operations, and arguments whose length alone puts them out of range never get that far
+ */
+static unsigned int typo_distance(const char* keyword, size_t m, const char* arg, size_t n) { /* m must be under 64 */
+    const unsigned long long last = 1ull << (m - 1);
+    unsigned long long vp = ~0ull, vn = 0, d0 = 0, prev_eq = 0;
+    unsigned int distance = (unsigned int)m;
+
+    for (size_t j = 0; j < n; j++) {
+        const char c = (char)tolower((unsigned char)arg[j]);
+        unsigned long long eq = 0;
+        for (size_t i = 0; i < m; i++) {
+            eq |= (unsigned long long)(keyword[i] == c) << i; }
+
+        const unsigned long long transposed = ((~d0 & eq) << 1) & prev_eq;
+        d0 = (((eq & vp) + vp) ^ vp) | eq | vn | transposed;
+        unsigned long long hp = vn | ~(d0 | vp);
+        unsigned long long hn = vp & d0;
+        distance += (hp & last) ? 1 : 0;
+        distance -= (hn & last) ? 1 : 0;
+        hp = (hp << 1) | 1; //The whole argument has to match, so the top row counts up rather than staying 0
+        hn <<= 1;
+        vp = hn | ~(d0 | hp);
+        vn = hp & d0;
+        prev_eq = eq;
+    }
+
+    return distance;
+}
+
+static int typo_match(const char* arg) {
+    if (*arg != '-') { /* Only options can be mistyped ones, "heap" or "session" are words or file names */
+        return dialogNone; }
+    while (*arg == '-') { arg++; }
+    size_t len = strlen(arg);
+    if (len == 0) {
+        return dialogNone; }
+
+    //No more than a third of the keyword, one typo for help and two for version, or most short options are in reach
+    const unsigned int help_max = options_t.typo_distance < 1 ? options_t.typo_distance : 1;
+    const unsigned int ver_max = options_t.typo_distance < 2 ? options_t.typo_distance : 2;
+    unsigned int help = MAX_TYPO_DISTANCE + 1, ver = MAX_TYPO_DISTANCE + 1; //Out of reach of either
+    if (len + help_max >= 4 && len <= 4 + help_max) {
+        help = typo_distance("help", 4, arg, len); }
+    if (len + ver_max >= 7 && len <= 7 + ver_max) {
+        ver = typo_distance("version", 7, arg, len); }
+
+    if (help <= help_max && help < ver) {
+        return dialogHelp; }
+    if (ver <= ver_max && ver < help) {
+        return dialogVer; }
+    return dialogNone; //Too far from both, or as close to one as the other
+}
+
+//Tests one argument for whichever dialogues haven't matched yet, recording index for those it does
+static void arg_test(const char* arg, int index, int* result_help, int* result_ver) {
+    const unsigned int maybe = arg_prefilter(arg);
+    bool is_help = *result_help == 0 && (maybe & prefilterHelp) != 0 && arg_is_help(arg);
+    bool is_ver  = *result_ver == 0 && (maybe & prefilterVer) != 0 && arg_is_ver(arg);
+    if (!is_help && !is_ver && options_t.typo_distance > 0) {
+        int typo = typo_match(arg);
+        is_help = *result_help == 0 && typo == dialogHelp;
+        is_ver  = *result_ver == 0 && typo == dialogVer; }
+
+    if (is_help) {
+        *result_help = index; }
+    if (is_ver) {
+        *result_ver = index; }
+}
+
+/*
+ * Argument sources, opt-in through help_handler_sources(). @file arguments are expanded where they stand, in GCC's
+ * syntax (whitespace separated, '' and "" quote, \ escapes the next byte, and a file can name further @files), and
+ * stdin is read after argv, one argument per line or NUL separated. Each open file gets one fixed buffer that
+ * arguments are NUL terminated and matched in, so a response file of a million arguments costs the same memory as
+ * one of ten, and reading stops as soon as both dialogues have matched. An argument longer than the buffer is
+ * matched on its first SOURCE_BUFFER_LEN bytes
+ */
+enum sourceSyntax {
+    syntaxLines = 0,
+    syntaxNul,
+    syntaxResponse, };
+
+struct arg_reader {
+    #ifdef HELP_HANDLER_POSIX_C
+    int fd;   //read() returns what a pipe has so far rather than waiting for a whole buffer
+    #else
+    FILE* fp;
+    #endif
+    int syntax;
+    char* data;    //SOURCE_BUFFER_LEN + 1, so even an argument that fills it can be NUL terminated
+    size_t start;  //The unfinished argument's first byte
+    size_t write;  //End of its bytes so far, which quotes and escapes can leave behind read
+    size_t read;   //Next byte to look at
+    size_t filled;
+    bool exhausted;
+    bool in_arg;
+    bool escaped;
+    bool skipping; //The rest of an argument that didn't fit
+    char quote;
+};
+
+static size_t reader_fill(struct arg_reader* r) {
+    char* to = r->data + r->write;
+    size_t size = SOURCE_BUFFER_LEN - r->write;
+    #ifdef HELP_HANDLER_POSIX_C
+    for (;;) {
+        ssize_t got = read(r->fd, to, size);
+        if (got >= 0) {
+            return (size_t)got; }
+        if (errno != EINTR) {
+            return 0; }
+    }
+    #else
+    return fread(to, 1, size, r->fp);
+    #endif
+}
 
+//Ends the argument at write. False for the tail of one that didn't fit, which was already handed out
+static bool reader_end(struct arg_reader* r, char** arg) {
+    bool keep = !r->skipping;
+    r->data[r->write] = '\0';
+    *arg = r->data + r->start;
+    r->skipping = false;
+    return keep;
+}
+
+static bool reader_split(struct arg_reader* r, char** arg) {
+    while (r->read < r->filled) {
+        char* found = (char*)memchr(r->data + r->read, r->syntax == syntaxLines ? '\n' : '\0', r->filled - r->read); //Cast to silence C++ warning
+        if (found == NULL) {
+            r->read = r->write = r->filled;
+            return false; }
+
+        size_t end = (size_t)(found - r->data);
+        r->write = r->syntax == syntaxLines && end > r->start && r->data[end-1] == '\r' ? end - 1 : end;
+        bool keep = reader_end(r, arg);
+        r->start = r->write = r->read = end + 1;
+        if (keep) {
+            return true; }
+    }
     return false;
 }
 
+//Unquotes in place, which only ever shortens an argument
+static bool reader_split_quoted(struct arg_reader* r, char** arg) {
+    char* data = r->data;
+    while (r->read < r->filled) {
+        if (!r->escaped && r->quote == 0) { //Runs of plain bytes in one go, data[filled] is a NUL to stop strcspn
+            size_t run = strcspn(data + r->read, " \t\n\r\v\f'\"\\");
+            if (run > 0) {
+                run = r->read + run > r->filled ? r->filled - r->read : run;
+                if (r->write != r->read) {
+                    memmove(data + r->write, data + r->read, run); }
+                r->write += run;
+                r->read += run;
+                r->in_arg = true;
+                continue; }
+        }
+
+        char c = data[r->read++];
+        if (r->escaped) {
+            r->escaped = false;
+            data[r->write++] = c;
+        } else if (c == '\\') {
+            r->escaped = r->in_arg = true;
+        } else if (r->quote != 0) {
+            if (c == r->quote) {
+                r->quote = 0;
+            } else {
+                data[r->write++] = c; }
+        } else if (c == '\'' || c == '"') {
+            r->quote = c;
+            r->in_arg = true;
+        } else if (c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' || c == '\f') {
+            bool ends = r->in_arg && reader_end(r, arg);
+            r->start = r->write = r->read;
+            r->in_arg = false;
+            if (ends) {
+                return true; }
+        } else {
+            data[r->write++] = c;
+            r->in_arg = true; }
+    }
+    return false;
+}
+
+//The next argument, NUL terminated and valid until the next call. False once the stream is exhausted
+static bool reader_next(struct arg_reader* r, char** arg) {
+    for (;;) {
+        if (r->syntax == syntaxResponse ? reader_split_quoted(r, arg) : reader_split(r, arg)) {
+            return true; }
+
+        if (r->exhausted) { //Whatever is left is the last argument
+            bool left = r->syntax == syntaxResponse ? r->in_arg : r->write > r->start;
+            if (r->syntax == syntaxLines && left && r->data[r->write-1] == '\r') {
+                r->write--; }
+            r->in_arg = false;
+            if (left && reader_end(r, arg)) {
+                r->start = r->write;
+                return true; }
+            return false;
+        }
+
+        //Move the unfinished argument to the front and read more after it. If it fills the buffer, match what's there
+        if (r->start > 0) {
+            memmove(r->data, r->data + r->start, r->write - r->start);
+            r->write -= r->start;
+            r->start = 0; }
+        r->read = r->filled = r->write;
+        if (r->write == SOURCE_BUFFER_LEN) {
+            bool keep = reader_end(r, arg);
+            r->skipping = true;
+            r->write = r->read = r->filled = 0;
+            if (keep) {
+                return true; }
+            continue;
+        }
+
+        size_t got = reader_fill(r);
+        r->exhausted = got == 0;
+        r->filled += got;
+        r->data[r->filled] = '\0';
+    }
+}
+
+static struct scan_t {
+    bool want_topic; //The help argument didn't name a topic itself, so the next argument may
+    const char* topic;
+    char topic_copy[MAX_TOPIC_LEN]; //topic, when it came from a read buffer that's about to be reused
+    unsigned long long streamed;    //Arguments read from response files and stdin
+} scan_t;
+
+static void scan_topic(const char* topic, bool lasts) {
+    if (lasts || topic == NULL) {
+        scan_t.topic = topic;
+    } else if (strlen(topic) < MAX_TOPIC_LEN) {
+        strcpy(scan_t.topic_copy, topic);
+        scan_t.topic = scan_t.topic_copy;
+    } else {
+        scan_t.topic = NULL; } //Longer than any [[topic]] line
+}
+
+//One argument, from argv (lasts) or a read buffer. index is what a match is recorded as. "--help topic",
+//"--help=topic" or "help:topic"
+static void arg_take(const char* arg, bool lasts, int index, int* result_help, int* result_ver) {
+    if (scan_t.want_topic && arg[0] != '-' && arg[0] != '\0') {
+        scan_topic(arg, lasts); }
+    scan_t.want_topic = false;
+    if (*result_help != 0 && *result_ver != 0) { //Past both, only reading on for the topic
+        return; }
+
+    int had_help = *result_help;
+    arg_test(arg, index, result_help, result_ver);
+    if (had_help == 0 && *result_help != 0) {
+        const char* named = strpbrk(arg, ":=");
+        scan_t.want_topic = named == NULL;
+        scan_topic(named != NULL && named[1] != '\0' ? named + 1 : NULL, lasts); }
+}
+
+static bool scan_done(const int* result_help, const int* result_ver) {
+    return *result_help != 0 && *result_ver != 0 && !scan_t.want_topic;
+}
+
+static void scan_reader(struct arg_reader* r, int index, int* result_help, int* result_ver, unsigned int depth);
+
+//False if file_name can't be opened, which leaves "@file_name" an ordinary argument, as GCC does
+static bool scan_response_file(const char* file_name, int index, int* result_help, int* result_ver, unsigned int depth) {
+    struct arg_reader r;
+    memset(&r, 0, sizeof(r));
+    r.syntax = syntaxResponse;
+    #ifdef HELP_HANDLER_POSIX_C
+    r.fd = open(file_name, O_RDONLY);
+    if (r.fd < 0) {
+        return false; }
+    #ifdef POSIX_FADV_SEQUENTIAL //Not declared in strict ISO C modes
+    posix_fadvise(r.fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+    #endif
+    #else
+    r.fp = fopen(file_name, "rb");
+    if (r.fp == NULL) {
+        return false; }
+    #endif
+
+    r.data = (char*)malloc(SOURCE_BUFFER_LEN + 1); //Cast to silence C++ warning
+    if (r.data != NULL) {
+        scan_reader(&r, index, result_help, result_ver, depth);
+        free(r.data);
+    } else {
+        print_err("could not allocate a buffer for a response file", __LINE__, warning); }
+
+    #ifdef HELP_HANDLER_POSIX_C
+    close(r.fd);
+    #else
+    fclose(r.fp);
+    #endif
+    return r.data != NULL;
+}
+
+static void scan_reader(struct arg_reader* r, int index, int* result_help, int* result_ver, unsigned int depth) {
+    char* arg;
+    while (!scan_done(result_help, result_ver) && reader_next(r, &arg)) {
+        if (arg[0] == '@' && arg[1] != '\0' && r->syntax == syntaxResponse && depth < MAX_SOURCE_DEPTH
+            && scan_response_file(arg + 1, index, result_help, result_ver, depth + 1)) {
+            continue; }
 
-static int arg_match(int argc, char** argv, const char* regex_string, const char* fallback_string) {
-    (void)regex_string; //Doesn't effect the variables. Only gets rid of unused parameter warning due to #ifdef below
-    (void)fallback_string;
+        scan_t.streamed++;
+        arg_take(arg, false, index, result_help, result_ver);
+    }
+}
+
+//Only when stdin was asked for and isn't a terminal, which someone would have to end input on before anything printed
+static bool reads_stdin(void) {
+    if ((options_t.sources & (HELP_HANDLER_STDIN_LINES | HELP_HANDLER_STDIN_NUL)) == 0) {
+        return false; }
+    #ifdef HELP_HANDLER_POSIX_C
+    return isatty(0) == 0;
+    #else
+    return true;
+    #endif
+}
+
+//Read after argv, as if appended to it. Put back where it was if it can seek, so the program reads it whole
+static void scan_stdin(int index, int* result_help, int* result_ver) {
+    struct arg_reader r;
+    memset(&r, 0, sizeof(r));
+    r.syntax = (options_t.sources & HELP_HANDLER_STDIN_NUL) != 0 ? syntaxNul : syntaxLines;
+    r.data = (char*)malloc(SOURCE_BUFFER_LEN + 1); //Cast to silence C++ warning
+    if (r.data == NULL) {
+        print_err("could not allocate a buffer for stdin", __LINE__, warning);
+        return; }
+
+    #ifdef HELP_HANDLER_POSIX_C
+    r.fd = 0;
+    off_t origin = lseek(0, 0, SEEK_CUR);
+    scan_reader(&r, index, result_help, result_ver, 0);
+    if (origin >= 0) {
+        lseek(0, origin, SEEK_SET); }
+    #else
+    r.fp = stdin;
+    long origin = ftell(stdin);
+    scan_reader(&r, index, result_help, result_ver, 0);
+    if (origin >= 0) {
+        fseek(stdin, origin, SEEK_SET); }
+    #endif
+    free(r.data);
+}
+
+//One pass over argv, then any sources, testing each argument for both dialogues, stopping as soon as both have matched
+static int arg_match(int argc, char** argv, int* result_help, int* result_ver) {
+    *result_help = 0;
+    *result_ver  = 0;
 
     if (argc > INT_MAX) {
         print_err("argument count (argc) is larger than the limit of int type", __LINE__, error);
@@ -412,91 +1159,46 @@ static int arg_match(int argc, char** argv, const char* regex_string, const char
     if (string_check(*argv, __LINE__, error, "argument value (argv)") == EXIT_FAILURE) {
         return helpHandlerFailure; }
 
-    for (int i = 1; i < argc; i++) { //Start from 1 to skip executable name
+    #ifdef HELP_HANDLER_REGEX_C
+    if (lex_compile() == EXIT_FAILURE) {
+        return helpHandlerFailure; }
+    #endif
+
+    HELP_HANDLER_PROBE1(match_start, argc);
+    HELP_HANDLER_STAT_START(start);
+    int i = 1; //Start from 1 to skip executable name
+    for (; i < argc && !scan_done(result_help, result_ver); i++) {
         if (argv[i] == NULL) {
             print_err("argument count (argc) exceeds actual number of arguments", __LINE__, error);
             return helpHandlerFailure; }
-    
-        #ifdef HELP_HANDLER_POSIX_C
-        if (regex_string != NULL) {
-            if (regex_match(argv[i], regex_string) == EXIT_SUCCESS) {
-                return i; }
-        }
-        #else
-        if (fallback_string != NULL) {
-            #if defined _WIN32 || defined _WIN64
-            int result = _stricmp(argv[i], fallback_string);
-            #else
-            int result = strcasecmp(argv[i], fallback_string);
-            #endif
 
-            if (result == 0) {
-                return i; }
-        }
-        #endif
+        if (argv[i][0] == '@' && argv[i][1] != '\0' && (options_t.sources & HELP_HANDLER_RESPONSE_FILES) != 0
+            && scan_response_file(argv[i] + 1, i, result_help, result_ver, 1)) {
+            continue; }
+        arg_take(argv[i], true, i, result_help, result_ver);
     }
+    if (!scan_done(result_help, result_ver) && reads_stdin()) {
+        scan_stdin(argc, result_help, result_ver); }
+    HELP_HANDLER_STAT_TIME(match_ns, start);
+    HELP_HANDLER_STAT_ADD(args_scanned, (unsigned long long)(i - 1) + scan_t.streamed);
+    HELP_HANDLER_PROBE2(match_done, *result_help, *result_ver);
 
-    return 0;
+    return helpHandlerSuccess;
 }
 
 static int help_handler_sub(int argc, char** argv) {
-    #ifndef HELP_HANDLER_POSIX_C
-    //Casts to silence C++ warnings
-    char* help_lex[] = {
-        (char*)"h", (char*)"-h", (char*)"--h",
-        (char*)"help", (char*)"-help", (char*)"--help",
-        (char*)"hhelp", (char*)"heelp", (char*)"hellp", (char*)"helpp",
-        (char*)"-hhelp", (char*)"-heelp", (char*)"-hellp", (char*)"-helpp",
-        (char*)"--hhelp", (char*)"--heelp", (char*)"--hellp", (char*)"--helpp" };
-    char* ver_lex[] = { 
-        (char*)"v", (char*)"-v", (char*)"--v",
-        (char*)"version", (char*)"-version", (char*)"--version",
-        (char*)"vversion", (char*)"veersion", (char*)"verrsion", (char*)"verssion", (char*)"versiion", (char*)"versioon", (char*)"versionn",
-        (char*)"-vversion", (char*)"-veersion", (char*)"-verrsion", (char*)"-verssion", (char*)"-versiion", (char*)"-versioon", (char*)"-versionn",
-        (char*)"--vversion", (char*)"--veersion", (char*)"--verrsion", (char*)"--verssion", (char*)"--versiion", (char*)"--versioon", (char*)"--versionn" };
-    int i = 0;
-
-    if (options_t.extra_strings != true) {
-        ver_lex[0]  = "";ver_lex[1]  = "";ver_lex[2]  = "";
-        help_lex[0] = "";help_lex[1] = "";help_lex[2] = ""; 
-        i = 3; } //First three elements of help/ver array should be abbreviated versions, hence setting the array index to the fourth element
-
-    int result_help, result_ver = 0;
-    for (; *help_lex[i] != '\0'; i++) {
-        int result;
-        result = arg_match(argc, argv, NULL, help_lex[i]);
-        if (help_handler_is_err(result)) { return result; }
-
-        if (result > 0) { result_help = result; }
-        for (; *ver_lex[i] != '\0'; j++) {
-            result = arg_match(argc, argv, NULL, ver_lex[i]);
-            if (help_handler_is_err(result)) { return result; }
-            if (result > 0) { result_ver = result; }
-        }
-    }
-
-    int r = return_result(result_help, result_ver);
-    if (r != 0) { return r; }
-    #else
-    char help_lex[MAX_STRING_LEN];
-    char ver_lex[MAX_STRING_LEN];
-    if (options_t.extra_strings == true) {
-        strcpy(help_lex, "-{0,}h{1,}e{1,}l{1,}p{1,}(.*)|-{0,}h{1,}$");
-        strcpy(ver_lex, "-{0,}v{1,}e{1,}r{1,}s{0,}i{0,}o{0,}n{0,}(.*)|^-{0,}v$");
-    } else {
-        strcpy(help_lex, "-{0,}h{1,}e{1,}l{1,}p{1,}(.*)"); 
-        strcpy(ver_lex, "-{0,}v{1,}e{1,}r{1,}s{0,}i{0,}o{0,}n{0,}(.*)"); }
+    int result_help, result_ver;
+    if (help_handler_is_err(arg_match(argc, argv, &result_help, &result_ver))) {
+        return helpHandlerFailure; }
 
-    int result_help = arg_match(argc, argv, help_lex, NULL);
-    if (help_handler_is_err(result_help)) { return result_help; }
-    int result_ver  = arg_match(argc, argv, ver_lex, NULL);
-    if (help_handler_is_err(result_ver)) { return result_ver; }
     int r = return_result(result_help, result_ver);
-    if (r != 0) { return r; }
-    #endif
+    if (r != dialogNone) { return r; }
 
-    if (true == options_t.unknown_arg_help && argc > 1) {
-        if (argc > 2) {
+    const unsigned long long given = (unsigned long long)(argc - 1) + scan_t.streamed;
+    if (given == 0 && options_t.no_arg_help == true) { //Only once stdin turned out to be empty too
+        return dialogNoArgs; }
+    if (true == options_t.unknown_arg_help && given > 0) {
+        if (given > 1) {
             print_pipe("Unknown arguments given\n"); 
         } else {
             print_pipe("Unknown argument given\n"); }
@@ -507,6 +1209,256 @@ static int help_handler_sub(int argc, char** argv) {
     return helpHandlerSuccess;
 }
 
+//Works out which dialogue argv asks for before anything has to touch the help text. scan_t.topic gets the topic the
+//help argument names, if any
+static int select_dialog(int argc, char** argv) {
+    HELP_HANDLER_STAT_ADD(calls, 1);
+    scan_t.want_topic = false;
+    scan_t.topic = NULL;
+    scan_t.streamed = 0;
+    if (argc == 1 && options_t.no_arg_help == true && !reads_stdin()) {
+        return dialogNoArgs; }
+
+    return help_handler_sub(argc, argv);
+}
+
+static bool dialog_needs_help(int dialog) {
+    return dialog == dialogNoArgs || dialog == dialogHelpVer || dialog == dialogHelp;
+}
+
+static void print_head(int dialog) {
+    if (dialog == dialogHelpVer) {
+        print_pipe_n(render_t.help_ver_head, render_t.help_ver_head_len);
+    } else if (dialog == dialogHelp || dialog == dialogNoArgs) {
+        print_pipe_n(render_t.help_head, render_t.help_head_len);
+    } else if (dialog == dialogVer) {
+        print_pipe_n(render_t.ver_only, render_t.ver_only_len); }
+}
+
+
+/*
+ * Sectioned help files
+ *
+ * A help file can be split into topics with lines of the form [[topic]], and "--help topic", "--help=topic" or
+ * "help:topic" then print only that topic's section (up to the next [[...]] line). Where each section is goes in a
+ * sidecar index, the help file's name plus ".idx", in the same format the C++ port reads and writes:
+ * "help_handler_index 2 <file size> <file mtime> <mtime nanoseconds>" then "<offset> <length> <topic>" per line, so a
+ * file rewritten within the same second at the same size still makes its index stale. A stale or missing index
+ * is rebuilt the first time a topic is asked for, so after that a topic costs reading the small index and then only
+ * the section's pages. The index built last is also kept in memory, so where it can't be written the file is still
+ * only scanned once. Without POSIX, or for a topic the file doesn't have, the whole file is printed as before
+ */
+#ifdef HELP_HANDLER_POSIX_C
+struct help_section {
+    size_t offset;
+    size_t length;
+};
+
+struct section_buffer { //Grows with realloc, and is freed and left NULL if that fails
+    char* data;
+    size_t size;
+    size_t capacity;
+    bool failed;
+};
+
+static void section_append(struct section_buffer* buffer, const char* s, size_t n) {
+    if (buffer->failed) {
+        return; }
+    if (buffer->size + n + 1 > buffer->capacity) {
+        size_t capacity = buffer->capacity == 0 ? 4096 : buffer->capacity;
+        while (buffer->size + n + 1 > capacity) {
+            capacity *= 2; }
+        char* grown = (char*)realloc(buffer->data, capacity); //Cast to silence C++ warning
+        if (grown == NULL) {
+            free(buffer->data);
+            buffer->data = NULL;
+            buffer->failed = true;
+            return; }
+        buffer->data = grown;
+        buffer->capacity = capacity;
+    }
+    memcpy(buffer->data + buffer->size, s, n);
+    buffer->size += n;
+    buffer->data[buffer->size] = '\0';
+}
+
+//The nanoseconds of the file's modification time, 0 where struct stat doesn't have them (then only seconds count)
+static long long section_mtime_nsec(const struct stat* st) {
+    #if defined(__APPLE__)
+    return (long long)st->st_mtimespec.tv_nsec;
+    #elif defined(__GLIBC__) && !defined(__USE_XOPEN2K8) //Strict C99, where glibc names it differently
+    return (long long)st->st_mtimensec;
+    #elif defined(_POSIX_VERSION) && _POSIX_VERSION >= 200809L
+    return (long long)st->st_mtim.tv_nsec;
+    #else
+    (void)st;
+    return 0;
+    #endif
+}
+
+static void section_entry(struct section_buffer* index, size_t start, size_t end, const char* topic, size_t topic_len) {
+    char line[64];
+    int n = snprintf(line, sizeof(line), "%llu %llu ", (unsigned long long)start, (unsigned long long)(end - start));
+    section_append(index, line, (size_t)n);
+    section_append(index, topic, topic_len);
+    section_append(index, "\n", 1);
+}
+
+//Appends the index for the help file in data to index, NUL terminated
+static void section_index_build(struct section_buffer* index, const char* data, size_t size, const struct stat* st) {
+    char line[96];
+    int n = snprintf(line, sizeof(line), "help_handler_index 2 %llu %lld %lld\n", (unsigned long long)st->st_size,
+                     (long long)st->st_mtime, section_mtime_nsec(st));
+    section_append(index, line, (size_t)n);
+
+    const char* topic = NULL;
+    size_t topic_len = 0, start = 0;
+    for (size_t at = 0; at < size; ) {
+        const char* end = (const char*)memchr(data + at, '\n', size - at);
+        size_t next = end != NULL ? (size_t)(end - data) + 1 : size;
+        size_t len = next - at - (end != NULL ? 1 : 0);
+        if (len > 0 && data[at + len - 1] == '\r') {
+            len--; }
+
+        //[[topic]], with no whitespace or ] inside
+        bool marker = len > 4 && data[at] == '[' && data[at + 1] == '[' && data[at + len - 2] == ']' && data[at + len - 1] == ']';
+        for (size_t i = at + 2; marker && i < at + len - 2; i++) {
+            marker = data[i] != ']' && data[i] != ' ' && data[i] != '\t'; }
+        if (marker) {
+            if (topic != NULL) {
+                section_entry(index, start, at, topic, topic_len); }
+            topic = data + at + 2;
+            topic_len = len - 4;
+            start = next;
+        }
+        at = next;
+    }
+    if (topic != NULL) {
+        section_entry(index, start, size, topic, topic_len); }
+}
+
+//1 if topic was found, 0 if the index is current but doesn't have it, -1 if it's stale or not an index
+static int section_lookup(const char* index, const struct stat* st, const char* topic, struct help_section* found) {
+    unsigned long long size;
+    long long mtime, mtime_nsec;
+    int header = 0;
+    if (sscanf(index, "help_handler_index 2 %llu %lld %lld\n%n", &size, &mtime, &mtime_nsec, &header) != 3 || header == 0
+        || size != (unsigned long long)st->st_size || mtime != (long long)st->st_mtime || mtime_nsec != section_mtime_nsec(st)) {
+        return -1; }
+
+    //Topics can't hold spaces, so " topic\n" only ever matches the end of that topic's line
+    size_t topic_len = strlen(topic);
+    if (topic_len == 0 || strpbrk(topic, " \t\r\n]") != NULL) {
+        return 0; }
+    for (const char* at = strstr(index + header, topic); at != NULL; at = strstr(at + 1, topic)) {
+        if (at[-1] != ' ' || at[topic_len] != '\n') {
+            continue; }
+
+        const char* line = at;
+        while (line > index + header && line[-1] != '\n') {
+            line--; }
+        char* rest;
+        unsigned long long offset = strtoull(line, &rest, 10);
+        unsigned long long length = strtoull(rest, &rest, 10);
+        if (*rest != ' ' || rest + 1 != at || offset > size || length > size - offset) {
+            return -1; }
+
+        found->offset = (size_t)offset;
+        found->length = (size_t)length;
+        return 1;
+    }
+    return 0;
+}
+
+static void section_read(struct section_buffer* out, const char* file_name) {
+    int fd = open(file_name, O_RDONLY);
+    if (fd < 0) {
+        return; }
+
+    char chunk[4096];
+    ssize_t got;
+    while ((got = read(fd, chunk, sizeof(chunk))) != 0) {
+        if (got < 0) {
+            if (errno == EINTR) { continue; }
+            out->size = 0; //Half an index is as good as none
+            break; }
+        section_append(out, chunk, (size_t)got); }
+    close(fd);
+}
+
+//Written to a temporary file first so a concurrent reader never sees half an index. The temporary's name is the
+//process, this call's stack frame and an attempt number, so concurrent writers (other threads included) never pick the
+//same one, and O_EXCL stops one from truncating another's regardless. Failing (a read-only directory, say) leaves the
+//index in section_cache only
+static void section_index_write(const char* index_name, const struct section_buffer* index) {
+    char temporary[4096];
+    int fd = -1;
+    for (int attempt = 0; attempt < 8 && fd < 0; attempt++) {
+        int n = snprintf(temporary, sizeof(temporary), "%s.%ld.%p.%d", index_name, (long)getpid(), (void*)&fd, attempt);
+        if (n < 0 || (size_t)n >= sizeof(temporary)) {
+            return; }
+        fd = open(temporary, O_WRONLY | O_CREAT | O_EXCL, 0644);
+        if (fd < 0 && errno != EEXIST) {
+            return; }
+    }
+    if (fd < 0) {
+        return; }
+
+    bool written = true;
+    for (size_t done = 0; done < index->size && written; ) {
+        ssize_t w = write(fd, index->data + done, index->size - done);
+        if (w < 0 && errno == EINTR) { continue; }
+        written = w > 0;
+        done += w > 0 ? (size_t)w : 0; }
+    if (close(fd) != 0 || written == false || rename(temporary, index_name) != 0) {
+        unlink(temporary); }
+}
+
+//The index section_find() built last, kept so a help file whose index can't be written isn't scanned on every call.
+//Freed by help_handler_cleanup()
+static struct {
+    char index_name[4096];
+    struct section_buffer index;
+} section_cache = { "", { NULL, 0, 0, false } };
+
+//Where topic is in the help file open as fd, rebuilding the index if it's stale. False if there's no such topic
+static bool section_find(const char* file_name, int fd, const struct stat* st, const char* topic, struct help_section* found) {
+    char index_name[4096];
+    int n = snprintf(index_name, sizeof(index_name), "%s.idx", file_name);
+    if (n < 0 || (size_t)n >= sizeof(index_name)) {
+        return false; }
+
+    if (section_cache.index.data != NULL && strcmp(section_cache.index_name, index_name) == 0) {
+        int result = section_lookup(section_cache.index.data, st, topic, found);
+        if (result >= 0) {
+            return result == 1; }
+    }
+
+    struct section_buffer index = { NULL, 0, 0, false };
+    section_read(&index, index_name);
+    int result = index.failed || index.size == 0 ? -1 : section_lookup(index.data, st, topic, found);
+    if (result < 0) {
+        void* data = mmap(NULL, (size_t)st->st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data != MAP_FAILED) {
+            index.size = 0;
+            section_index_build(&index, (const char*)data, (size_t)st->st_size, st);
+            munmap(data, (size_t)st->st_size);
+            if (index.failed == false) {
+                section_index_write(index_name, &index);
+                result = section_lookup(index.data, st, topic, found);
+
+                free(section_cache.index.data);
+                memcpy(section_cache.index_name, index_name, (size_t)n + 1);
+                section_cache.index = index;
+                return result == 1; }
+        }
+    }
+
+    free(index.data);
+    return result == 1;
+}
+#endif
+
 
 
 
@@ -530,6 +1482,7 @@ void help_handler_print_err(void) {
         print_pipe(" ERROR ");
         print_pipe(errs[i]);
     }
+    flush_pipe();
 }
 
 char* help_handler_get_err(void) {
@@ -540,6 +1493,43 @@ char* help_handler_get_err(void) {
     return NULL;
 }
 
+void help_handler_sink_fd(int fd) {
+    sink_t.type = sinkFd;
+    sink_t.fd   = fd;
+}
+
+void help_handler_sink_file(FILE* file) {
+    if (file == NULL) {
+        print_err("file is NULL", __LINE__, warning);
+        return; }
+
+    sink_t.type = sinkFile;
+    sink_t.file = file;
+}
+
+//Output is appended to buffer, truncated at capacity. length holds the total that was written, and is reset by the caller
+void help_handler_sink_buffer(char* buffer, size_t capacity, size_t* length) {
+    if (buffer == NULL || length == NULL) {
+        print_err("buffer or length is NULL", __LINE__, warning);
+        return; }
+
+    sink_t.type     = sinkBuffer;
+    sink_t.buffer   = buffer;
+    sink_t.capacity = capacity;
+    sink_t.length   = length;
+}
+
+void help_handler_sink_callback(help_handler_callback callback, void* context) {
+    if (callback == NULL) {
+        print_err("callback is NULL", __LINE__, warning);
+        return; }
+
+    sink_t.type     = sinkCallback;
+    sink_t.callback = callback;
+    sink_t.context  = context;
+}
+
+//Kept for compatibility, these are now shorthand for help_handler_sink_fd() with stdout or stderr
 #ifdef HELP_HANDLER_OVERLOAD_SUPPORTED
 void help_handler_pipe_s(const char* output_pipe) {
 #else
@@ -549,38 +1539,82 @@ void help_handler_pipe(const char* output_pipe) {
         return; }
 
     #if defined _WIN32 || defined _WIN64
-    if (_stricmp(output_pipe, "stdout") == 0) {
-        outputPipe = outStdout;
-    } else if (_stricmp(output_pipe, "stderr") == 0) {
-        outputPipe = outStderr;
-    } else {
-        outputPipe = outDefault; }
+    if (_stricmp(output_pipe, "stderr") == 0) {
     #else
-    if (strcasecmp(output_pipe, "stdout") == 0) {
-        outputPipe = outStdout;
-    } else if (strcasecmp(output_pipe, "stderr") == 0) {
-        outputPipe = outStderr;
-    } else {
-        outputPipe = outDefault; }
+    if (strcasecmp(output_pipe, "stderr") == 0) {
     #endif
+        help_handler_sink_fd(2);
+    } else {
+        help_handler_sink_fd(1); }
 }
 
 void help_handler_pipe_i(int output_pipe) {
-    if (output_pipe == outStdout) {
-        outputPipe = output_pipe;
-    } else if (output_pipe == outStderr) {
-        outputPipe = output_pipe;
+    if (output_pipe == outStderr) {
+        help_handler_sink_fd(2);
     } else {
-        outputPipe = outDefault;
-    }
+        help_handler_sink_fd(1); }
 }
 
 void help_handler_config(bool extra_strings, bool no_arg_help, bool unknown_arg_help) {
+    #ifdef HELP_HANDLER_REGEX_C
+    if (extra_strings != options_t.extra_strings) {
+        lex_free(); } //Recompiled with the new setting on next use
+    #endif
     options_t.extra_strings    = extra_strings;
     options_t.no_arg_help      = no_arg_help;
     options_t.unknown_arg_help = unknown_arg_help;
 }
 
+//Also match options up to max_distance typos from help/version (at most 1 for help, 2 for version). 0, the default, turns it off
+void help_handler_typos(unsigned int max_distance) {
+    options_t.typo_distance = max_distance < MAX_TYPO_DISTANCE ? max_distance : MAX_TYPO_DISTANCE;
+}
+
+//Registers the name and version HELP_HANDLER_NOTE embedded, exactly as the note holds them so helpscan and --version
+//print the same bytes, and keeps its help text for help_handler_noted_help(). desc is "name\0version\0help", and the
+//macro has already checked that both fit. Called by the macro, not meant to be called directly
+void help_handler_note_info(const char* desc) {
+    const char* ver = desc + strlen(desc) + 1;
+    strcpy(info_t.name, desc);
+    strcpy(info_t.ver_str, ver);
+    info_t.noted_help = ver + strlen(ver) + 1;
+    most_recent_t.name = nameChar;
+    most_recent_t.ver  = versionStr;
+    render();
+}
+
+//The help text given to HELP_HANDLER_NOTE, for help_handler(), or NULL without one
+const char* help_handler_noted_help(void) {
+    return info_t.noted_help;
+}
+
+//Also read arguments from "@file" response files and/or stdin: HELP_HANDLER_RESPONSE_FILES, HELP_HANDLER_STDIN_LINES
+//or HELP_HANDLER_STDIN_NUL, or'd together. 0, the default, reads argv only
+void help_handler_sources(unsigned int which) {
+    options_t.sources = which;
+}
+
+#ifdef HELP_HANDLER_STATS
+struct help_handler_stats help_handler_get_stats(void) {
+    return stats_t;
+}
+
+void help_handler_reset_stats(void) {
+    memset(&stats_t, 0, sizeof(stats_t));
+}
+#endif
+
+//Frees the compiled regexes. Optional, for leak checkers; the next help_handler call compiles them again
+void help_handler_cleanup(void) {
+    #ifdef HELP_HANDLER_REGEX_C
+    lex_free();
+    #endif
+    #ifdef HELP_HANDLER_POSIX_C
+    free(section_cache.index.data);
+    section_cache.index.data = NULL;
+    #endif
+}
+
 #ifdef HELP_HANDLER_OVERLOAD_SUPPORTED
 int help_handler_version_s(const char* ver) { //Parent function
 #else
@@ -591,21 +1625,21 @@ int help_handler_version(const char* ver) {
         print_err("given version string is larger than allowed", __LINE__, error);
         return helpHandlerFailure; }
 
-    char* version = (char*)malloc(strlen(ver)+1);
-    trim(version, strlen(ver)+1, ver);
-    strcpy(info_t.ver_str, version);
+    trim(info_t.ver_str, sizeof(info_t.ver_str), ver);
     most_recent_t.ver = versionStr;
+    render();
 
-    free(version);
     return helpHandlerSuccess;
 } 
 void help_handler_version_i(unsigned int ver) {
     info_t.ver_int = ver;
     most_recent_t.ver = versionInt;
+    render();
 }
 void help_handler_version_d(double ver) {
     info_t.ver_double = ver;
     most_recent_t.ver = versionDouble;
+    render();
 }
 
 
@@ -619,22 +1653,22 @@ int help_handler_name(const char* app_name) {
         print_err("given app name is larger than allowed", __LINE__, error);
         return helpHandlerFailure; }
 
-    char* name = (char*)malloc(strlen(app_name)+1);
-    trim(name, strlen(app_name)+1, app_name);
-    strcpy(info_t.name, name);
+    trim(info_t.name, sizeof(info_t.name), app_name);
     most_recent_t.name = nameChar;
+    render();
 
     return helpHandlerSuccess;
 }
 
 int help_handler_name_w(const wchar_t* app_name) { //Parent function
-    if (string_check((char*)app_name, __LINE__, error, "app_name") == EXIT_FAILURE) { return helpHandlerFailure; }
-    if (wcslen(app_name)+1 >= sizeof(info_t.name)) {
+    if (string_check_w(app_name, __LINE__, error, "app_name") == EXIT_FAILURE) { return helpHandlerFailure; }
+    if (wcslen(app_name)+1 >= sizeof(info_t.name_w) / sizeof(info_t.name_w[0])) {
         print_err("given app name (wchar type) is larger than allowed", __LINE__, warning);
         return helpHandlerFailure; }
 
     wcscpy(info_t.name_w, app_name);
     most_recent_t.name = nameWChar;
+    render();
 
     return helpHandlerSuccess;
 }
@@ -677,114 +1711,222 @@ int help_handler_s(int argc, char** argv, const char* help_dialogue) {
 #else
 int help_handler(int argc, char** argv, const char* help_dialogue) {
 #endif
-    char* help = (char*)malloc(strlen("No usage help is available")+1); //Cast to silence C++ warning    
+    const char* help = "No usage help is available";
     if (string_check(help_dialogue, __LINE__, silent, NULL) == EXIT_SUCCESS) {
-        help = (char*)realloc(help, strlen(help_dialogue)+1);
-        strcpy(help, help_dialogue); } 
-    if (argc == 1 && options_t.no_arg_help == true) {
-        if (print_name()) { 
-            print_pipe(" "); }
-        print_pipe(help); 
-        print_pipe("\n");
- 
-        free(help);
-        return helpHandlerSuccess;
-    }
+        help = help_dialogue; }
+    int dialog = select_dialog(argc, argv);
+    if (help_handler_is_err(dialog)) {
+        return dialog; }
 
-    int result = help_handler_sub(argc, argv);
-    if (result == dialogHelpVer) {
-        if (print_name()) {
-            print_pipe(" Version "); }
-        print_ver();
-        print_pipe("\n");
-        print_pipe(help);
-    } else if (result == dialogHelp) {
-        if (print_name()) {
-            print_pipe(" "); }
+    print_head(dialog);
+    if (dialog_needs_help(dialog)) {
         print_pipe(help);
-    } else if (result == dialogVer) {
-        print_ver();
-    } else if (help_handler_is_err(result)) { return result; }
-    
-    print_pipe("\n");
+        print_pipe("\n"); }
+    flush_pipe();
 
-
-    free(help);
     return helpHandlerSuccess;
 }
 
 int help_handler_w(int argc, char** argv, const wchar_t* help_dialogue) {
-    wchar_t* help = (wchar_t*)L"No usage help is available"; //Cast to silence C++ warning
-    if (string_check_w(help_dialogue, __LINE__, silent, NULL) == EXIT_FAILURE) {
-        help = (wchar_t*)malloc(wcslen(help_dialogue)+1);
-        wcscpy(help, help_dialogue); }
-    if (argc == 1 && options_t.no_arg_help == true) {
-        if (print_name()) { 
-            print_pipe(" "); }
-        print_pipe_w(help); 
-        print_pipe("\n");
-        return helpHandlerSuccess;
-    }
-
-    int result = help_handler_sub(argc, argv);
-    if (result == dialogHelpVer) {
-        if (print_name()) {
-            print_pipe(" Version "); }
-        print_ver();
-        print_pipe("\n");
+    const wchar_t* help = L"No usage help is available";
+    if (string_check_w(help_dialogue, __LINE__, silent, NULL) == EXIT_SUCCESS) {
+        help = help_dialogue; }
+    int dialog = select_dialog(argc, argv);
+    if (help_handler_is_err(dialog)) {
+        return dialog; }
+
+    print_head(dialog);
+    if (dialog_needs_help(dialog)) {
         print_pipe_w(help);
-    } else if (result == dialogHelp) {
-        if (print_name()) {
-            print_pipe(" "); }
-        print_pipe_w(help);
-    } else if (result == dialogVer) {
-        print_ver();
-    } else if (help_handler_is_err(result)) { return result; }
-    
-    print_pipe("\n");
+        print_pipe("\n"); }
+    flush_pipe();
 
+    return helpHandlerSuccess;
+}
+
+//Each chunk goes out before write() returns (the head with the first one), so providers may reuse their buffers
+static bool provider_wrote = false;
+static void provider_write(const char* data, size_t size) {
+    if (data == NULL || size == 0) {
+        return; }
+
+    print_pipe_n(data, size);
+    flush_pipe();
+    provider_wrote = true;
+}
+
+int help_handler_p(int argc, char** argv, help_handler_provider provider, void* context) {
+    int dialog = select_dialog(argc, argv);
+    if (help_handler_is_err(dialog)) {
+        return dialog; }
+
+    print_head(dialog);
+    if (dialog_needs_help(dialog)) {
+        provider_wrote = false;
+        if (provider != NULL) {
+            provider(provider_write, context); }
+        if (provider_wrote == false) {
+            print_pipe("No usage help is available"); }
+        print_pipe("\n"); }
+    flush_pipe();
 
-    free(help);
     return helpHandlerSuccess;
 }
 
+//The file is only opened if the help dialogue is actually going to be printed, and is printed byte for byte
 int help_handler_f(int argc, char** argv, const char* file_name) {
     if (string_check(file_name, __LINE__, error, "file_name") == EXIT_FAILURE) {
         return helpHandlerFailure; }
 
-    FILE* fp = fopen(file_name, "rb"); //Windows mangles newlines in r, so use rb
-    if (fp == NULL) {
+    int dialog = select_dialog(argc, argv);
+    if (help_handler_is_err(dialog)) {
+        return dialog; }
+    if (!dialog_needs_help(dialog)) {
+        print_head(dialog);
+        flush_pipe();
+        return helpHandlerSuccess; }
+
+    HELP_HANDLER_PROBE1(file_start, file_name);
+    HELP_HANDLER_STAT_START(start);
+    #ifdef HELP_HANDLER_POSIX_C
+    //Served straight from a read-only mapping, so memory stays flat however large the file is
+    int fd = open(file_name, O_RDONLY);
+    if (fd < 0) {
         print_err(strerror(errno), __LINE__, error);
         return helpHandlerFailure; }
 
-    fseek(fp, 0L, SEEK_END);
-    long size = ftell(fp);
-    rewind(fp);
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        print_err(strerror(errno), __LINE__, error);
+        close(fd);
+        return helpHandlerFailure; }
+    if (st.st_size == 0) {
+        print_err("given help file is empty", __LINE__, error); 
+        close(fd);
+        return helpHandlerFailure; }
 
-    char* contents = NULL;
-    if ((contents = (char*)malloc((unsigned long)size+1)) == NULL) { 
-        print_err("failed to allocate memory", __LINE__, error);
+    //Map only the section's pages when a topic was asked for and found
+    struct help_section section = { 0, (size_t)st.st_size };
+    if (scan_t.topic != NULL && section_find(file_name, fd, &st, scan_t.topic, &section) == false) {
+        section.offset = 0;
+        section.length = (size_t)st.st_size; }
+    size_t skip = section.offset % (size_t)sysconf(_SC_PAGESIZE);
+
+    size_t size = section.length;
+    size_t mapping_size = size + skip;
+    char* mapping = NULL;
+    if (mapping_size > 0) {
+        mapping = (char*)mmap(NULL, mapping_size, PROT_READ, MAP_PRIVATE, fd, (off_t)(section.offset - skip)); } //Cast to silence C++ warning
+    close(fd); //The mapping keeps its own reference
+    if ((void*)mapping == MAP_FAILED) {
+        print_err(strerror(errno), __LINE__, error);
+        return helpHandlerFailure; }
+    #ifdef MADV_SEQUENTIAL //Not declared in strict ISO C modes
+    if (mapping != NULL) {
+        madvise(mapping, mapping_size, MADV_SEQUENTIAL); }
+    #endif
+    const char* contents = mapping + skip;
+    HELP_HANDLER_STAT_TIME(file_ns, start);
+    HELP_HANDLER_STAT_ADD(file_loads, 1);
+    HELP_HANDLER_STAT_ADD(file_bytes, size);
+    HELP_HANDLER_PROBE2(file_done, file_name, size);
+
+    print_head(dialog);
+    print_pipe_n(contents, size);
+    if (size == 0 || contents[size-1] != '\n') {
+        print_pipe("\n"); }
+    flush_pipe();
+
+    if (mapping != NULL) {
+        munmap(mapping, mapping_size); }
+    #else
+    //No mmap, so stream it through a fixed buffer instead
+    FILE* fp = fopen(file_name, "rb"); //Windows mangles newlines in r, so use rb
+    if (fp == NULL) {
+        print_err(strerror(errno), __LINE__, error);
         return helpHandlerFailure; }
 
-    size_t n_items = fread(contents, 1, (size_t)size, fp);
+    char chunk[4096];
+    size_t n_items = fread(chunk, 1, sizeof(chunk), fp);
     if (n_items == 0) {
         print_err("given help file is empty", __LINE__, error); 
+        fclose(fp);
         return helpHandlerFailure; }
-    if ((long)n_items < size) {
+    HELP_HANDLER_STAT_TIME(file_ns, start);
+    HELP_HANDLER_STAT_ADD(file_loads, 1);
+    HELP_HANDLER_PROBE2(file_done, file_name, n_items);
+
+    char last = '\0';
+    print_head(dialog);
+    while (n_items > 0) {
+        HELP_HANDLER_STAT_ADD(file_bytes, n_items);
+        print_pipe_n(chunk, n_items);
+        flush_pipe();
+        last = chunk[n_items-1];
+        n_items = fread(chunk, 1, sizeof(chunk), fp); }
+    if (ferror(fp)) {
         print_err(strerror(errno), __LINE__, error);
+        fclose(fp);
         return helpHandlerFailure; }
+    if (last != '\n') {
+        print_pipe("\n"); }
+    flush_pipe();
+
     if (fclose(fp) == EOF) {
         print_err(strerror(errno), __LINE__, error);
         return helpHandlerFailure; }
+    #endif
 
-    int return_val = help_handler(argc, argv, (const char*)contents);
-    if (contents) { free(contents); }
-    return return_val;
+    return helpHandlerSuccess;
 }
 
 
+/*
+ * HELP_HANDLER_NOTE("name", "version", "help dialogue");
+ *
+ * Embeds the name, version and help text in an ELF note (.note.helphandler, owner "HelpHandler", type 1) at
+ * compile time, so cpp/tools/helpscan can read them without executing the binary, and registers the same bytes as the
+ * name and version before main(). Use it once at file scope in place of help_handler_info(), and pass
+ * help_handler_noted_help() to help_handler(), so there's only one copy for the scanner and --version/--help to
+ * disagree about. The arguments must be string literals, and a name or version too long for help_handler_info() fails
+ * to compile. Elsewhere than ELF there is no note, but the name and version are still registered
+ */
+#ifdef __GNUC__
+    #if defined(__ELF__)
+        #define HELP_HANDLER_NOTE_SECTION __attribute__((section(".note.helphandler"), used, aligned(4)))
+    #else
+        #define HELP_HANDLER_NOTE_SECTION
+    #endif
+    #define HELP_HANDLER_NOTE(app_name, app_version, help_dialogue) \
+        HELP_HANDLER_NOTE_SECTION static const struct { \
+            unsigned int name_size, desc_size, type; \
+            char name[12]; \
+            char desc[(sizeof(app_name) + sizeof(app_version) + sizeof(help_dialogue) + 3) & ~3u]; \
+        } help_handler_note = { 12, sizeof(app_name) + sizeof(app_version) + sizeof(help_dialogue), 1, "HelpHandler", app_name "\0" app_version "\0" help_dialogue }; \
+        typedef char help_handler_note_fits[sizeof(app_name) < sizeof(info_t.name) && sizeof(app_version) < sizeof(info_t.ver_str) ? 1 : -1]; \
+        __attribute__((constructor(102))) static void help_handler_note_register(void) { help_handler_note_info(help_handler_note.desc); } \
+        extern int help_handler_note_unsupported
+#else
+    #define HELP_HANDLER_NOTE(app_name, app_version, help_dialogue) extern int help_handler_note_unsupported
+#endif
+
+
 #undef MAX_STRING_LEN
 #undef MAX_STRING_COUNT
+#undef MAX_FRAGMENTS
+#undef MAX_SCRATCH_LEN
+#undef MAX_RENDER_LEN
+#undef MAX_TYPO_DISTANCE
+#undef SOURCE_BUFFER_LEN
+#undef MAX_SOURCE_DEPTH
+#undef MAX_TOPIC_LEN
 #undef HELP_HANDLER_POSIX_C
+#undef HELP_HANDLER_REGEX_C
 #undef HELP_HANDLER_OVERLOAD_SUPPORTED
+#undef HELP_HANDLER_STAT_ADD
+#undef HELP_HANDLER_STAT_START
+#undef HELP_HANDLER_STAT_TIME
+#undef HELP_HANDLER_PROBE
+#undef HELP_HANDLER_PROBE1
+#undef HELP_HANDLER_PROBE2
 #endif  /* HELP_HANDLER_H */
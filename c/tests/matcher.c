@@ -0,0 +1,153 @@
+/*
+ * Cross-checks the hand-written matcher (what non-POSIX and HELP_HANDLER_NO_REGEX builds use) against the REG_ICASE
+ * regexes, with extra_strings off and on. The corpus is generated: "help"/"version" and their prefixes with letters
+ * repeated, dropped and randomly recased, buried at any position among other text, dashes, trailing h/v, and plain
+ * random bytes. Then a fixed list of typo matching cases, words and file names that must not count as help or version
+ * among them, which runs either way. Exits 1 on any difference, and 77 (skipped) where there's no regex.h to check the
+ * hand-written matcher against
+ *
+ * gcc -std=c99 -O2 matcher.c -o matcher && ./matcher [arguments=300000] [seed]
+ */
+#include "../help_handler.h"
+
+
+
+
+static unsigned int seed = 12345;
+static unsigned int next(void) {
+    seed = seed * 1103515245 + 12345;
+    return seed >> 8;
+}
+
+static char recase(char c) {
+    return next() % 3 == 0 ? (char)toupper((unsigned char)c) : c;
+}
+
+//A keyword or a prefix of one, each letter repeated 0 to 3 times and randomly recased
+static size_t keyword(char* out) {
+    static const char* words[] = { "help", "version", "ver", "he", "hel", "ve", "vers" };
+    const char* word = words[next() % (sizeof(words) / sizeof(words[0]))];
+    size_t at = 0;
+    for (const char* c = word; *c != '\0'; c++) {
+        unsigned int repeat = next() % 12 == 0 ? 0 : next() % 6 == 0 ? 1 + next() % 3 : 1;
+        while (repeat-- > 0) {
+            out[at++] = recase(*c); }
+    }
+    return at;
+}
+
+static void argument(char* out) {
+    static const char filler[] = "-hHvVelpELPrRsionx=:/._ ";
+    size_t at = 0;
+    const unsigned int kind = next() % 8;
+    if (kind == 0) { //Random bytes, any of them but NUL
+        for (unsigned int n = next() % 16; n > 0; n--) {
+            out[at++] = (char)(1 + next() % 255); }
+        out[at] = '\0';
+        return; }
+
+    for (unsigned int n = next() % 3; n > 0; n--) {
+        out[at++] = '-'; }
+    if (kind <= 2) { //Short forms, which only match with extra_strings, sometimes after other text
+        for (unsigned int n = next() % 2 == 0 ? 0 : 1 + next() % 4; n > 0; n--) {
+            out[at++] = filler[next() % (sizeof(filler) - 1)]; }
+        for (unsigned int n = 1 + next() % 2; n > 0; n--) {
+            out[at++] = recase(next() % 2 == 0 ? 'h' : 'v'); }
+    } else { //A keyword anywhere, regexec() searches rather than anchoring
+        for (unsigned int n = next() % 3 == 0 ? next() % 6 : 0; n > 0; n--) {
+            out[at++] = filler[next() % (sizeof(filler) - 1)]; }
+        at += keyword(out + at); }
+    for (unsigned int n = next() % 3 == 0 ? 1 + next() % 5 : 0; n > 0; n--) {
+        out[at++] = filler[next() % (sizeof(filler) - 1)]; }
+    out[at] = '\0';
+}
+
+
+
+
+//Typo matching only looks at options, and only as far as a third of the keyword. Returns the number of mismatches
+static unsigned long typo_cases(void) {
+    //Expected at typos 1, 2 and 3 (which is 2)
+    static const struct { const char* arg; int expected[3]; } cases[] = {
+        { "heap", { dialogNone, dialogNone, dialogNone } }, { "yelp", { dialogNone, dialogNone, dialogNone } },
+        { "kelp", { dialogNone, dialogNone, dialogNone } }, { "tell", { dialogNone, dialogNone, dialogNone } },
+        { "hello", { dialogNone, dialogNone, dialogNone } }, { "session", { dialogNone, dialogNone, dialogNone } },
+        { "person", { dialogNone, dialogNone, dialogNone } }, { "vision", { dialogNone, dialogNone, dialogNone } },
+        { "hepl.c", { dialogNone, dialogNone, dialogNone } }, { "-tell", { dialogNone, dialogNone, dialogNone } },
+        { "--hell0", { dialogNone, dialogNone, dialogNone } }, { "--passion", { dialogNone, dialogNone, dialogNone } },
+        { "--hlep", { dialogHelp, dialogHelp, dialogHelp } }, { "-HEPL", { dialogHelp, dialogHelp, dialogHelp } },
+        { "-hlp", { dialogHelp, dialogHelp, dialogHelp } }, { "--verison", { dialogVer, dialogVer, dialogVer } },
+        { "--vresoin", { dialogNone, dialogVer, dialogVer } }, { "--Versoin", { dialogVer, dialogVer, dialogVer } },
+    };
+
+    unsigned long mismatches = 0;
+    for (unsigned int distance = 1; distance <= 3; distance++) {
+        help_handler_typos(distance);
+        for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+            const int got = typo_match(cases[i].arg);
+            if (got != cases[i].expected[distance - 1]) {
+                mismatches++;
+                printf("typos %u: \"%s\" matched %d, expected %d\n", distance, cases[i].arg, got, cases[i].expected[distance - 1]); }
+        }
+    }
+
+    //And the whole way through: "tool session" is a program called with a word, not a version request
+    char* argv[] = { "tool", "session", NULL };
+    char out[64];
+    size_t length = 0;
+    help_handler_info("tool", "1.0");
+    help_handler_config(true, true, false);
+    help_handler_typos(2);
+    help_handler_sink_buffer(out, sizeof(out), &length);
+    const int matched = help_handler(2, argv, "usage: tool");
+    if (matched != 0 || length != 0) {
+        mismatches++;
+        printf("typos 2: \"tool session\" matched %d and printed %lu bytes\n", matched, (unsigned long)length); }
+    help_handler_typos(0);
+    help_handler_sink_fd(1);
+    return mismatches;
+}
+
+
+
+
+int main(int argc, char** argv) {
+    const unsigned long typo_mismatches = typo_cases();
+    printf("typo cases, %lu mismatches\n", typo_mismatches);
+    #ifndef REG_ICASE //regex.h is only included when the regexes are used
+    (void)argc; (void)argv; (void)argument;
+    printf("no regex.h in this build, nothing to check the hand-written matcher against\n");
+    return typo_mismatches == 0 ? 77 : EXIT_FAILURE;
+    #else
+    const unsigned long count = argc > 1 ? strtoul(argv[1], NULL, 10) : 300000;
+    seed = argc > 2 ? (unsigned int)strtoul(argv[2], NULL, 10) : seed;
+
+    unsigned long checked = 0, mismatches = typo_mismatches, matched = 0;
+    char arg[64];
+    for (int extra_strings = 0; extra_strings <= 1; extra_strings++) {
+        help_handler_config(extra_strings == 1, true, false);
+        if (lex_compile() == EXIT_FAILURE) {
+            return EXIT_FAILURE; }
+
+        for (unsigned long i = 0; i < count; i++) {
+            argument(arg);
+            const bool regex_help = regexec(&lex_t.help, arg, 0, NULL, 0) == 0;
+            const bool regex_ver  = regexec(&lex_t.ver, arg, 0, NULL, 0) == 0;
+            const bool hand_help  = hand_is_help(arg);
+            const bool hand_ver   = hand_is_ver(arg);
+            matched += regex_help || regex_ver;
+            checked++;
+            if ((regex_help != hand_help || regex_ver != hand_ver) && ++mismatches <= 10) {
+                printf("mismatch, extra_strings %d: \"", extra_strings);
+                for (const unsigned char* c = (const unsigned char*)arg; *c != '\0'; c++) {
+                    printf(*c >= 0x20 && *c < 0x7f ? "%c" : "\\x%02x", *c); }
+                printf("\" regex help %d version %d, by hand help %d version %d\n", regex_help, regex_ver, hand_help, hand_ver);
+            }
+        }
+    }
+    help_handler_cleanup();
+
+    printf("%lu arguments, %lu matched help or version, %lu mismatches\n", checked, matched, mismatches);
+    return mismatches == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+    #endif
+}
@@ -0,0 +1,151 @@
+/*
+ * The section index as the C port reads it: section_lookup() takes only a current index (size, mtime and its
+ * nanoseconds), turns down version 1, truncated and corrupt indexes and sections reaching past the file, and matches
+ * only whole topics. Then help_handler_f() the whole way through: a garbage .idx is rebuilt, and a file rewritten at
+ * the same size within the same second prints its new section. Exits 1 on any failure, 77 (skipped) without POSIX
+ *
+ * gcc -std=c99 -O2 sections.c -o sections && ./sections
+ */
+#include "../help_handler.h"
+
+
+
+
+#ifdef _POSIX_VERSION //The header undefines HELP_HANDLER_POSIX_C at its end
+static const char* file_name = "/tmp/help_handler_sections_c_test.txt";
+static const char* index_name = "/tmp/help_handler_sections_c_test.txt.idx";
+static unsigned long failures = 0;
+
+static void write_file(const char* name, const char* text) {
+    FILE* fp = fopen(name, "wb");
+    fputs(text, fp);
+    fclose(fp);
+}
+
+static int lookup(const char* index, const struct stat* st, const char* topic, struct help_section* found) {
+    found->offset = found->length = 0;
+    return section_lookup(index, st, topic, found);
+}
+
+static void parser(void) {
+    const char* text = "usage: app\n[[one]]\nfirst\n[[done]]\r\nsecond\n[[two]]\nthird";
+    write_file(file_name, text);
+    struct stat st;
+    stat(file_name, &st);
+    struct section_buffer index = { NULL, 0, 0, false };
+    section_index_build(&index, text, strlen(text), &st);
+
+    char head[128], expected[256];
+    snprintf(head, sizeof(head), "help_handler_index 2 %lld %lld %lld\n", (long long)st.st_size, (long long)st.st_mtime, section_mtime_nsec(&st));
+    snprintf(expected, sizeof(expected), "%s19 6 one\n35 7 done\n50 5 two\n", head);
+    if (index.data == NULL || strcmp(index.data, expected) != 0) {
+        failures++;
+        printf("built \"%s\"\n", index.data != NULL ? index.data : "(nothing)"); }
+
+    static const struct { const char* topic; int expected; size_t offset, length; } topics[] = {
+        { "one", 1, 19, 6 }, { "done", 1, 35, 7 }, { "two", 1, 50, 5 },
+        { "on", 0, 0, 0 }, { "ne", 0, 0, 0 }, { "three", 0, 0, 0 }, { "", 0, 0, 0 }, { "one two", 0, 0, 0 },
+    };
+    for (size_t i = 0; i < sizeof(topics) / sizeof(topics[0]); i++) {
+        struct help_section found;
+        const int got = lookup(index.data, &st, topics[i].topic, &found);
+        if (got != topics[i].expected || (got == 1 && (found.offset != topics[i].offset || found.length != topics[i].length))) {
+            failures++;
+            printf("topic \"%s\" gave %d at %lu+%lu\n", topics[i].topic, got, (unsigned long)found.offset, (unsigned long)found.length); }
+    }
+
+    //Anything but a current, well formed index is stale
+    char stale[11][160];
+    snprintf(stale[0], sizeof(stale[0]), "help_handler_index 1 %lld %lld\n19 6 one\n", (long long)st.st_size, (long long)st.st_mtime);
+    snprintf(stale[1], sizeof(stale[1]), "help_handler_index 2 %lld %lld %lld\n19 6 one\n", (long long)st.st_size + 1, (long long)st.st_mtime, section_mtime_nsec(&st));
+    snprintf(stale[2], sizeof(stale[2]), "help_handler_index 2 %lld %lld %lld\n19 6 one\n", (long long)st.st_size, (long long)st.st_mtime + 1, section_mtime_nsec(&st));
+    snprintf(stale[3], sizeof(stale[3]), "help_handler_index 2 %lld %lld %lld\n19 6 one\n", (long long)st.st_size, (long long)st.st_mtime, section_mtime_nsec(&st) + 1);
+    snprintf(stale[4], sizeof(stale[4]), "%s", "");
+    snprintf(stale[5], sizeof(stale[5]), "%s", "garbage\n19 6 one\n");
+    snprintf(stale[6], sizeof(stale[6]), "%s19 9999 one\n", head);
+    snprintf(stale[7], sizeof(stale[7]), "%s9999 1 one\n", head);
+    snprintf(stale[8], sizeof(stale[8]), "%s19 x one\n", head);
+    snprintf(stale[9], sizeof(stale[9]), "%s19 6  one\n", head);
+    snprintf(stale[10], sizeof(stale[10]), "%s", "help_handler_index 2 55\n19 6 one\n");
+    for (size_t i = 0; i < sizeof(stale) / sizeof(stale[0]); i++) {
+        struct help_section found;
+        if (lookup(stale[i], &st, "one", &found) != -1) {
+            failures++;
+            printf("accepted \"%s\"\n", stale[i]); }
+    }
+
+    //Every prefix of the index is either stale, current without the topic, or gives the right section
+    for (size_t cut = 0; index.data != NULL && cut < index.size; cut++) {
+        char prefix[256];
+        memcpy(prefix, index.data, cut);
+        prefix[cut] = '\0';
+        struct help_section found;
+        if (lookup(prefix, &st, "done", &found) == 1 && (found.offset != 35 || found.length != 7)) {
+            failures++;
+            printf("index cut at %lu gave %lu+%lu\n", (unsigned long)cut, (unsigned long)found.offset, (unsigned long)found.length); }
+    }
+    free(index.data);
+}
+
+static void expect(const char* topic, const char* expected, const char* what) {
+    char* argv[] = { "app", "--help", (char*)topic, NULL };
+    char out[256];
+    size_t length = 0;
+    help_handler_sink_buffer(out, sizeof(out), &length);
+    help_handler_f(3, argv, file_name);
+    help_handler_sink_fd(1);
+    if (length >= sizeof(out) || length != strlen(expected) || memcmp(out, expected, length) != 0) {
+        failures++;
+        printf("%s printed \"%.*s\", expected \"%s\"\n", what, (int)(length < sizeof(out) ? length : sizeof(out)), out, expected); }
+}
+
+static void handler(void) {
+    help_handler_name("app");
+    unlink(index_name);
+    write_file(file_name, "usage\n[[a]]\nAAAA\n[[b]]\nBB\n");
+    expect("b", "app BB\n", "first lookup");
+    struct stat st;
+    if (stat(index_name, &st) != 0) {
+        failures++;
+        printf("no index written\n"); }
+
+    write_file(index_name, "help_handler_index 2 garbage\n");
+    expect("a", "app AAAA\n", "lookup with a garbage index");
+
+    //Same size, other offsets, and (retried until it is) the same second: only the nanoseconds tell them apart
+    struct stat before, after;
+    const char* texts[] = { "usage\n[[a]]\nAA\n[[b]]\nBBBB\n", "usage\n[[a]]\nAAAA\n[[b]]\nBB\n" };
+    for (int attempt = 0; attempt < 10; attempt++) {
+        write_file(file_name, texts[1]);
+        expect("b", "app BB\n", "lookup before the rewrite");
+        stat(file_name, &before);
+        write_file(file_name, texts[0]);
+        stat(file_name, &after);
+        if (after.st_mtime == before.st_mtime) {
+            break; }
+    }
+    if (after.st_mtime != before.st_mtime || section_mtime_nsec(&after) == section_mtime_nsec(&before)) {
+        printf("no nanosecond timestamps here, skipping the same-second rewrite\n");
+    } else {
+        expect("b", "app BBBB\n", "same-second rewrite"); }
+
+    help_handler_cleanup();
+    unlink(file_name);
+    unlink(index_name);
+}
+#endif
+
+
+
+
+int main(void) {
+    #ifndef _POSIX_VERSION
+    printf("no sectioned help files without POSIX\n");
+    return 77;
+    #else
+    parser();
+    handler();
+    printf("%lu failures\n", failures);
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+    #endif
+}
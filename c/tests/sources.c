@@ -0,0 +1,269 @@
+/*
+ * Argument sources as the C port reads them: reader_next() splits response files like a plain reference splitter of
+ * GCC's syntax (quotes, \ escapes, whitespace including \r), on fixed cases and on generated files big enough that
+ * arguments straddle buffer refills, and splits stdin lines dropping a \r before the \n. Then help_handler() with
+ * help_handler_sources(): nested @files up to 8 deep, a file naming itself, a missing file left as an ordinary
+ * argument, and stdin put back where it was, judged by what gets printed. Exits 1 on any failure, 77 (skipped)
+ * without POSIX
+ *
+ * gcc -std=c99 -O2 sources.c -o sources && ./sources [files=40] [seed]
+ */
+#include "../help_handler.h"
+
+
+
+
+#ifdef _POSIX_VERSION //The header undefines HELP_HANDLER_POSIX_C at its end
+static const char* directory = "/tmp/hh_sources_c_test"; //No "help" in it, which the C port matches anywhere in an argument
+static unsigned long failures = 0;
+
+static unsigned int seed = 12345;
+static unsigned int next(void) {
+    seed = seed * 1103515245 + 12345;
+    return seed >> 8;
+}
+
+static const char* path(const char* name) {
+    static char paths[4][256];
+    static int turn = 0;
+    turn = (turn + 1) % 4;
+    snprintf(paths[turn], sizeof(paths[turn]), "%s/%s", directory, name);
+    return paths[turn];
+}
+
+static void write_file(const char* name, const char* text, size_t size) {
+    FILE* fp = fopen(name, "wb");
+    fwrite(text, 1, size, fp);
+    fclose(fp);
+}
+
+//GCC's response file syntax, the slow and obvious way: the arguments, each followed by a NUL, into out
+static size_t reference(const char* text, size_t size, char* out, size_t* count) {
+    size_t written = 0;
+    bool in_arg = false, escaped = false;
+    char quote = 0;
+    *count = 0;
+    for (size_t i = 0; i < size; i++) {
+        const char c = text[i];
+        if (escaped) {
+            escaped = false;
+            out[written++] = c;
+        } else if (c == '\\') {
+            escaped = in_arg = true;
+        } else if (quote != 0) {
+            if (c == quote) {
+                quote = 0;
+            } else {
+                out[written++] = c; }
+        } else if (c == '\'' || c == '"') {
+            quote = c;
+            in_arg = true;
+        } else if (c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' || c == '\f') {
+            if (in_arg) {
+                out[written++] = '\0';
+                (*count)++; }
+            in_arg = false;
+        } else {
+            out[written++] = c;
+            in_arg = true; }
+    }
+    if (in_arg) {
+        out[written++] = '\0';
+        (*count)++; }
+    return written;
+}
+
+//What reader_next() hands out for a file in the given syntax, the same way
+static size_t split(const char* name, int syntax, char* out, size_t* count) {
+    struct arg_reader r;
+    memset(&r, 0, sizeof(r));
+    r.syntax = syntax;
+    r.fd = open(name, O_RDONLY);
+    r.data = (char*)malloc((1 << 16) + 1);
+    size_t written = 0;
+    char* arg;
+    *count = 0;
+    while (reader_next(&r, &arg)) {
+        const size_t len = strlen(arg) + 1;
+        memcpy(out + written, arg, len);
+        written += len;
+        (*count)++; }
+    free(r.data);
+    close(r.fd);
+    return written;
+}
+
+static void compare(const char* text, size_t size, int syntax, const char* expected, size_t expected_size, const char* what) {
+    static char got[1 << 20];
+    size_t count;
+    write_file(path("split"), text, size);
+    const size_t got_size = split(path("split"), syntax, got, &count);
+    if (got_size != expected_size || memcmp(got, expected, got_size) != 0) {
+        failures++;
+        printf("%s split into %lu bytes of arguments, expected %lu\n", what, (unsigned long)got_size, (unsigned long)expected_size); }
+}
+
+static void syntax_cases(unsigned long files) {
+    static const struct { const char* text; const char* expected; size_t expected_size; } cases[] = {
+        { "a b\tc\n d", "a\0b\0c\0d", 8 },
+        { "'a b' \"c d\" e'f g'h", "a b\0c d\0ef gh", 14 },
+        { "a\\ b \\\"q\\\" \\\\ \\'", "a b\0\"q\"\0\\\0'", 12 },
+        { "'' \"\" x", "\0\0x", 4 },
+        { "a\r\nb\r\n", "a\0b", 4 },
+        { "'unterminated quote", "unterminated quote", 19 },
+        { "trailing\\", "trailing", 9 },
+        { " \n\t ", "", 0 },
+    };
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        compare(cases[i].text, strlen(cases[i].text), syntaxResponse, cases[i].expected, cases[i].expected_size, cases[i].text); }
+
+    static const struct { const char* text; size_t size; int syntax; const char* expected; size_t expected_size; } streams[] = {
+        { "a\r\nb c\n\nd", 9, syntaxLines, "a\0b c\0\0d", 9 },
+        { "'quoted'\r\n", 10, syntaxLines, "'quoted'", 9 },
+        { "only\r", 5, syntaxLines, "only", 5 },
+        { "a b\0c\r\n\0\0d", 11, syntaxNul, "a b\0c\r\n\0\0d", 11 },
+    };
+    for (size_t i = 0; i < sizeof(streams) / sizeof(streams[0]); i++) {
+        compare(streams[i].text, streams[i].size, streams[i].syntax, streams[i].expected, streams[i].expected_size, "stream"); }
+
+    //Generated files, with runs long enough to straddle a refill but not to outgrow the buffer, where C truncates
+    static const char alphabet[] = "ab-\\'\"  \n\r\t";
+    static char text[300000], expected[300000];
+    for (unsigned long f = 0; f < files; f++) {
+        const size_t size = next() % 3 == 0 ? 1 + next() % 4096 : 60000 + next() % 150000;
+        for (size_t at = 0; at < size; ) {
+            if (next() % 2000 == 0) {
+                size_t run = next() % 30000;
+                run = run < size - at ? run : size - at;
+                memset(text + at, 'c' + next() % 20, run);
+                at += run;
+            } else {
+                text[at++] = alphabet[next() % (sizeof(alphabet) - 1)]; }
+        }
+        size_t count;
+        const size_t expected_size = reference(text, size, expected, &count);
+        char what[64];
+        snprintf(what, sizeof(what), "generated file %lu", f);
+        compare(text, size, syntaxResponse, expected, expected_size, what);
+    }
+}
+
+//What help_handler() printed: 0 nothing, 1 help, 2 the version alone
+static int run(const char* arg) {
+    char* argv[] = { "app", (char*)arg, NULL };
+    char out[256];
+    size_t length = 0;
+    help_handler_sink_buffer(out, sizeof(out) - 1, &length);
+    help_handler(2, argv, "usage: app");
+    help_handler_sink_fd(1);
+    out[length < sizeof(out) - 1 ? length : sizeof(out) - 1] = '\0';
+    return length == 0 ? 0 : strstr(out, "usage: app") != NULL ? 1 : 2;
+}
+
+static void expect(const char* text, int expected, const char* what) {
+    char at_file[300];
+    write_file(path("file.rsp"), text, strlen(text));
+    snprintf(at_file, sizeof(at_file), "@%s", path("file.rsp"));
+    const int matched = run(at_file);
+    if (matched != expected) {
+        failures++;
+        printf("%s matched %d, expected %d\n", what, matched, expected); }
+}
+
+static void expand_files(void) {
+    help_handler_info("app", "1.0");
+    help_handler_sources(HELP_HANDLER_RESPONSE_FILES);
+
+    //d1 names d2, which names d3... and only dk holds --help. The 8th file is still read, the 9th no longer
+    for (unsigned k = 1; k <= 10; k++) {
+        for (unsigned d = 1; d <= 10; d++) {
+            char name[16], text[300];
+            snprintf(name, sizeof(name), "d%u", d);
+            snprintf(text, sizeof(text), "x @%s/d%u", directory, d + 1);
+            write_file(path(name), d == k ? "x --help" : text, strlen(d == k ? "x --help" : text)); }
+        char at_file[300], what[64];
+        snprintf(at_file, sizeof(at_file), "@%s", path("d1"));
+        snprintf(what, sizeof(what), "--help %u files deep", k);
+        const int matched = run(at_file);
+        if ((matched != 0) != (k <= 8)) {
+            failures++;
+            printf("%s matched %d\n", what, matched); }
+    }
+
+    char self[300];
+    snprintf(self, sizeof(self), "@%s x", path("file.rsp"));
+    expect(self, 0, "a file naming itself");
+    expect("'--he'lp", 1, "quoted --help");
+    expect("--\\help", 1, "escaped --help");
+    expect("x\r\n--version\r\n", 2, "CRLF lines");
+    char missing[300];
+    snprintf(missing, sizeof(missing), "@%s", path("missing.rsp"));
+    expect(missing, 0, "a missing file inside a file");
+    if (run(missing) != 0) {
+        failures++;
+        printf("a missing file matched\n"); }
+
+    help_handler_sources(0);
+    write_file(path("file.rsp"), "--help", 6);
+    char at_file[300];
+    snprintf(at_file, sizeof(at_file), "@%s", path("file.rsp"));
+    if (run(at_file) != 0) {
+        failures++;
+        printf("@file expanded without help_handler_sources()\n"); }
+}
+
+//stdin read after argv, then put back so the program reads it whole
+static void read_stdin(void) {
+    const int saved = dup(0);
+    static const struct { const char* text; size_t size; unsigned int source; bool matches; } cases[] = {
+        { "x\r\n--help\r\n", 11, HELP_HANDLER_STDIN_LINES, true },
+        { "x\n--he lp\n", 10, HELP_HANDLER_STDIN_LINES, false },
+        { "x\0--help\0", 9, HELP_HANDLER_STDIN_NUL, true },
+        { "x\0--he\0lp\0", 10, HELP_HANDLER_STDIN_NUL, false },
+    };
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        write_file(path("stdin"), cases[i].text, cases[i].size);
+        const int fd = open(path("stdin"), O_RDONLY);
+        dup2(fd, 0);
+        close(fd);
+        help_handler_sources(cases[i].source);
+        const int matched = run("x");
+        if ((matched != 0) != cases[i].matches) {
+            failures++;
+            printf("stdin case %lu matched %d\n", (unsigned long)i, matched); }
+
+        char back[64];
+        if (read(0, back, sizeof(back)) != (ssize_t)cases[i].size || memcmp(back, cases[i].text, cases[i].size) != 0) {
+            failures++;
+            printf("stdin case %lu wasn't put back\n", (unsigned long)i); }
+    }
+    help_handler_sources(0);
+    dup2(saved, 0);
+    close(saved);
+}
+#endif
+
+
+
+
+int main(int argc, char** argv) {
+    #ifndef _POSIX_VERSION
+    (void)argc; (void)argv;
+    printf("no argument sources to test without POSIX\n");
+    return 77;
+    #else
+    const unsigned long files = argc > 1 ? strtoul(argv[1], NULL, 10) : 40;
+    seed = argc > 2 ? (unsigned int)strtoul(argv[2], NULL, 10) : seed;
+    mkdir(directory, 0755);
+    syntax_cases(files);
+    expand_files();
+    read_stdin();
+
+    const char* names[] = { "split", "file.rsp", "stdin", "d1", "d2", "d3", "d4", "d5", "d6", "d7", "d8", "d9", "d10" };
+    for (size_t i = 0; i < sizeof(names) / sizeof(names[0]); i++) {
+        unlink(path(names[i])); }
+    rmdir(directory);
+    printf("%lu failures\n", failures);
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+    #endif
+}
@@ -0,0 +1,14 @@
+/*
+ * Java port driver for conformance/run.py. HELP_HANDLER_CONFIG holds extraStrings, noArgHelp and unknownArgHelp
+ * as three 0/1 digits, the library's defaults are kept when it isn't set
+ */
+public class Driver {
+    public static void main(final String args[]) throws Exception {
+        final String config = System.getenv("HELP_HANDLER_CONFIG");
+        if (config != null && config.length() == 3) {
+            HelpHandler.config(config.charAt(1) == '1', config.charAt(0) == '1', config.charAt(2) == '1'); }
+
+        HelpHandler.version("9.8.7");
+        HelpHandler.handle(args, "usage: app [options]");
+    }
+}
@@ -0,0 +1,22 @@
+/*
+ * C port driver for conformance/run.py. HELP_HANDLER_CONFIG holds extra_strings, no_arg_help and unknown_arg_help
+ * as three 0/1 digits, the library's defaults are kept when it isn't set
+ */
+#include "../../c/help_handler.h"
+
+#include <stdlib.h>
+
+
+
+
+int main(int argc, char** argv) {
+    const char* config = getenv("HELP_HANDLER_CONFIG");
+    if (config != NULL && strlen(config) == 3) {
+        help_handler_config(config[0] == '1', config[1] == '1', config[2] == '1'); }
+
+    help_handler_info("app", "9.8.7");
+    if (help_handler_is_err(help_handler(argc, argv, "usage: app [options]"))) {
+        return EXIT_FAILURE; }
+
+    return EXIT_SUCCESS;
+}
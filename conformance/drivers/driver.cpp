@@ -0,0 +1,23 @@
+/*
+ * C++ port driver for conformance/run.py. HELP_HANDLER_CONFIG holds extraStrings, noArgHelp and unknownArgHelp
+ * as three 0/1 digits, the library's defaults are kept when it isn't set
+ */
+#include "../../cpp/helpHandler.hpp"
+
+
+
+
+int main(int argc, char** argv) {
+    const char* config = std::getenv("HELP_HANDLER_CONFIG");
+    if (config != nullptr && std::strlen(config) == 3) {
+        helpHandler::config(config[0] == '1', config[1] == '1', config[2] == '1'); }
+
+    try {
+        helpHandler::info("app", "9.8.7");
+        helpHandler::handle(argc, argv, "usage: app [options]");
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << "\n";
+        return EXIT_FAILURE; }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,16 @@
+-- Lua port driver for conformance/run.py. HELP_HANDLER_CONFIG holds extra_strings, no_arg_help and unknown_arg_help
+-- as three 0/1 digits, the library's defaults are kept when it isn't set
+local here = arg[0]:match("(.*/)") or "./"
+package.path = package.path .. ";" .. here .. "../../lua/?.lua"
+require "HelpHandler"
+
+
+
+
+local config = os.getenv("HELP_HANDLER_CONFIG")
+if config ~= nil and #config == 3 then
+    HelpHandler.config(config:sub(1, 1) == "1", config:sub(2, 2) == "1", config:sub(3, 3) == "1")
+end
+
+HelpHandler.info("app", "9.8.7")
+HelpHandler.handle("usage: app [options]")
@@ -0,0 +1,20 @@
+# Python port driver for conformance/run.py. HELP_HANDLER_CONFIG holds extraStrings, noArgHelp and unknownArgHelp
+# as three 0/1 digits, the library's defaults are kept when it isn't set
+import os, sys
+sys.path.append(os.path.join(os.path.dirname(os.path.dirname(os.path.dirname(os.path.abspath(__file__)))), "python"))
+from help_handler import *
+
+
+
+
+def main():
+    config = os.environ.get("HELP_HANDLER_CONFIG", "")
+    if len(config) == 3:
+        help_handler_config(config[1] == "1", config[0] == "1", config[2] == "1")
+
+    help_handler_version("9.8.7")
+    help_handler("usage: app [options]")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,243 @@
+'''
+MIT License
+
+Copyright (c) 2021 Inaff
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+'''
+
+'''
+Runs corpus.txt through every port available on this machine (C, C++, Python, Lua, Java) and checks they agree with
+the C port: which dialogues were printed, in which order, and the exit status. Then times process startup, spawn to
+exit, for each port next to an empty C program.
+
+Exits 1 if any port disagrees with C. Ports whose toolchain isn't installed are skipped.
+
+usage: python3 run.py (3.8 or later, POSIX only) [--ports c,cpp,python,lua,java] [--runs N] [--no-latency] [--record file.tsv]
+  --runs       spawns per latency case (default 200)
+  --record     append the latency table and disagreement counts to a TSV file, to track them over time
+  CC/CXX pick the C and C++ compilers (gcc and g++ by default)
+'''
+
+import argparse, os, shlex, shutil, subprocess, sys, tempfile, time
+
+
+HERE    = os.path.dirname(os.path.abspath(__file__))
+DRIVERS = os.path.join(HERE, "drivers")
+ROOT    = os.path.dirname(HERE)
+
+HELP_TEXT    = b"usage: app [options]" #What the drivers pass in
+VERSION_TEXT = b"9.8.7"
+UNKNOWN_TEXT = b"Unknown argument"
+
+LATENCY_CASES = [[], ["--help"], ["build"]]
+
+
+
+
+def build_ports(names, tmp):
+    '''Returns {name: command} for each port that could be built, and {name: reason} for the rest'''
+    cc  = os.environ.get("CC", "gcc")
+    cxx = os.environ.get("CXX", "g++")
+    ports, skipped = {}, {}
+
+    def compile(name, command, output):
+        if shutil.which(command[0]) is None:
+            skipped[name] = command[0] + " not found"
+            return
+        result = subprocess.run(command, stdout=subprocess.PIPE, stderr=subprocess.STDOUT)
+        if result.returncode != 0:
+            skipped[name] = "build failed:\n" + result.stdout.decode(errors="replace")
+            return
+        ports[name] = output
+
+    for name in names:
+        if name == "c":
+            compile(name, [cc, "-std=c99", "-O2", os.path.join(DRIVERS, "driver.c"), "-o", os.path.join(tmp, "c")], [os.path.join(tmp, "c")])
+        elif name == "cpp":
+            compile(name, [cxx, "-std=c++11", "-O2", os.path.join(DRIVERS, "driver.cpp"), "-o", os.path.join(tmp, "cpp")], [os.path.join(tmp, "cpp")])
+        elif name == "python":
+            ports[name] = [sys.executable, os.path.join(DRIVERS, "driver.py")]
+        elif name == "lua":
+            lua = next((l for l in ("lua", "lua5.4", "lua5.3", "luajit") if shutil.which(l)), None)
+            if lua is None:
+                skipped[name] = "lua not found"
+            else:
+                ports[name] = [lua, os.path.join(DRIVERS, "driver.lua")]
+        elif name == "java":
+            if shutil.which("java") is None:
+                skipped[name] = "java not found"
+            else:
+                compile(name, ["javac", "-d", tmp, os.path.join(ROOT, "java", "HelpHandler.java"), os.path.join(DRIVERS, "Driver.java")],
+                        ["java", "-cp", tmp, "Driver"])
+        else:
+            skipped[name] = "unknown port"
+
+    return ports, skipped
+
+
+def load_corpus():
+    cases = []
+    with open(os.path.join(HERE, "corpus.txt")) as f:
+        for line in f:
+            line = line.strip()
+            if not line or line.startswith("#"):
+                continue
+            fields = shlex.split(line)
+            cases.append((fields[0], fields[1:]))
+    return cases
+
+
+def dialogue(output):
+    '''What was printed, in order: H(elp), V(ersion), U(nknown), or - for nothing'''
+    found = [(output.find(text), letter) for text, letter in ((HELP_TEXT, "H"), (VERSION_TEXT, "V"), (UNKNOWN_TEXT, "U"))]
+    found = sorted((at, letter) for at, letter in found if at >= 0)
+    return "".join(letter for _, letter in found) or "-"
+
+
+def run_case(command, config, args):
+    env = dict(os.environ, HELP_HANDLER_CONFIG=config)
+    try:
+        result = subprocess.run(command + args, env=env, stdout=subprocess.PIPE, stderr=subprocess.PIPE, timeout=30)
+    except subprocess.TimeoutExpired:
+        return "timeout", None, b""
+    return dialogue(result.stdout), result.returncode, result.stdout
+
+
+def spawn_ns(command, env):
+    devnull = [(os.POSIX_SPAWN_OPEN, fd, os.devnull, os.O_WRONLY, 0) for fd in (1, 2)]
+    start = time.perf_counter_ns()
+    pid = os.posix_spawnp(command[0], command, env, file_actions=devnull)
+    os.waitpid(pid, 0)
+    return time.perf_counter_ns() - start
+
+
+def percentile(sorted_values, p): #Nearest rank
+    return sorted_values[min(len(sorted_values) - 1, max(0, int(round(p / 100.0 * len(sorted_values))) - 1))]
+
+
+def case_label(config, args):
+    return (config + " " + " ".join(shlex.quote(a) for a in args)).strip()
+
+
+
+
+def conformance(ports, names):
+    reference = names[0]
+    cases = load_corpus()
+    disagreements = {name: 0 for name in names}
+    byte_diffs = {name: 0 for name in names}
+
+    width = max(len(case_label(c, a)) for c, a in cases) + 2
+    print("%-*s" % (width, "case") + "".join("%-10s" % n for n in names))
+    for config, args in cases:
+        results = {name: run_case(ports[name], config, args) for name in names}
+        ref_dialogue, ref_status, ref_output = results[reference]
+
+        row = "%-*s" % (width, case_label(config, args))
+        for name in names:
+            shown, status, output = results[name]
+            cell = shown if status == 0 else "%s(%s)" % (shown, status)
+            if (shown, status) != (ref_dialogue, ref_status):
+                disagreements[name] += 1
+                cell += " *"
+            if output != ref_output:
+                byte_diffs[name] += 1
+            row += "%-10s" % cell
+        print(row)
+
+    print()
+    print("H help, V version, U unknown argument(s), - nothing, (n) exit status n, * disagrees with %s" % reference)
+    for name in names[1:]:
+        print("%-8s %3d of %d cases disagree with %s, %d print different bytes" % (name, disagreements[name], len(cases), reference, byte_diffs[name]))
+    return disagreements
+
+
+def latency(ports, names, runs, tmp):
+    cc = os.environ.get("CC", "gcc")
+    baseline = os.path.join(tmp, "baseline")
+    with open(baseline + ".c", "w") as f:
+        f.write("int main(void) { return 0; }\n")
+    commands = dict(ports)
+    if subprocess.run([cc, "-O2", baseline + ".c", "-o", baseline]).returncode == 0:
+        commands["baseline"] = [baseline]
+        names = ["baseline"] + names
+
+    rows = []
+    print()
+    print("%-10s %-10s %12s %12s" % ("port", "argv", "p50 us", "p99 us"))
+    for name in names:
+        for args in LATENCY_CASES:
+            env = dict(os.environ, HELP_HANDLER_CONFIG="110")
+            command = commands[name] + args
+            for _ in range(min(5, runs)): #Warm the page cache and the interpreter's files
+                spawn_ns(command, env)
+            samples = sorted(spawn_ns(command, env) for _ in range(runs))
+            p50, p99 = percentile(samples, 50) / 1000.0, percentile(samples, 99) / 1000.0
+            label = " ".join(args) or "(none)"
+            rows.append((name, label, p50, p99))
+            print("%-10s %-10s %12.1f %12.1f" % (name, label, p50, p99))
+    return rows
+
+
+def record(path, rows, disagreements):
+    revision = subprocess.run(["git", "-C", ROOT, "rev-parse", "--short", "HEAD"], stdout=subprocess.PIPE, stderr=subprocess.DEVNULL)
+    revision = revision.stdout.decode().strip() or "-"
+    stamp = time.strftime("%Y-%m-%dT%H:%M:%S")
+
+    new = not os.path.exists(path)
+    with open(path, "a") as f:
+        if new:
+            f.write("time\trevision\tport\targv\tp50_us\tp99_us\tdisagreements\n")
+        for name, label, p50, p99 in rows:
+            f.write("%s\t%s\t%s\t%s\t%.1f\t%.1f\t%s\n" % (stamp, revision, name, label, p50, p99, disagreements.get(name, "-")))
+
+
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Cross-port conformance and startup latency for Help-Handler")
+    parser.add_argument("--ports", default="c,cpp,python,lua,java")
+    parser.add_argument("--runs", type=int, default=200)
+    parser.add_argument("--no-latency", action="store_true")
+    parser.add_argument("--record")
+    options = parser.parse_args()
+
+    tmp = tempfile.mkdtemp(prefix="help_handler_conformance_")
+    try:
+        ports, skipped = build_ports(options.ports.split(","), tmp)
+        for name, reason in skipped.items():
+            print("skipping %s: %s" % (name, reason))
+        names = [n for n in options.ports.split(",") if n in ports]
+        if not names:
+            print("no ports available")
+            return 1
+
+        disagreements = conformance(ports, names)
+        rows = [] if options.no_latency else latency(ports, names, options.runs, tmp)
+        if options.record:
+            record(options.record, rows, disagreements)
+    finally:
+        shutil.rmtree(tmp, ignore_errors=True)
+
+    return 1 if any(disagreements.values()) else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,170 @@
+/*
+ * Help in 30 locales of ~120KB and 40 topics each, served three ways: 30 loose help files through handleFile(), one
+ * bundle through handleBundle() for plain --help, and the same bundle for "--help topic". For each, the time from the
+ * call to the last byte written (warm, and cold with the files dropped from the page cache by posix_fadvise()), how
+ * much of the file ends up in the page cache after a cold call (mincore()), and how much the call holds by the time it
+ * writes: file pages mapped into the process, and heap in use (glibc's mallinfo2()). Disk sizes are printed first,
+ * next to what embedding every locale as a string literal would add to the binary
+ *
+ * g++ -std=c++11 -O2 bundle.cpp -o bundle && ./bundle
+ */
+#include "../helpHandler.hpp"
+
+
+#include <chrono>
+#include <algorithm>
+#include <malloc.h>
+
+
+
+
+static const char* directory = "/tmp/help_handler_bundle";
+static const int localeCount = 30;
+static const int topicCount  = 40;
+
+typedef std::chrono::steady_clock clock_type;
+static std::vector<char> copied(4 << 20);
+static long mappedAtWrite, heapAtWrite; //KiB, sampled while the call still holds everything it loaded
+
+//File pages mapped into the process, and heap in use
+static void memory(long& mapped, long& heap) {
+    long size = 0, resident = 0;
+    FILE* fp = std::fopen("/proc/self/statm", "r");
+    if (fp == nullptr || std::fscanf(fp, "%ld %ld %ld", &size, &resident, &mapped) != 3) {
+        mapped = 0; }
+    if (fp != nullptr) {
+        std::fclose(fp); }
+    mapped *= ::sysconf(_SC_PAGESIZE) / 1024;
+
+    const struct mallinfo2 info = ::mallinfo2();
+    heap = (long)((info.uordblks + info.hblkhd) / 1024);
+}
+
+static void copy(const helpHandler::fragment* fragments, size_t count, void*) {
+    size_t at = 0;
+    for (size_t i = 0; i < count; i++) {
+        std::memcpy(copied.data() + at, fragments[i].data, fragments[i].size);
+        at += fragments[i].size; }
+    memory(mappedAtWrite, heapAtWrite);
+}
+
+//Sentences from a vocabulary of its own per locale, so locales don't compress against each other
+static std::string localeText(int locale) {
+    unsigned seed = 2166136261u ^ (unsigned)locale;
+    auto next = [&seed]() { seed = seed * 1103515245 + 12345; return seed >> 8; };
+    std::vector<std::string> words(400);
+    for (std::string& word: words) {
+        for (unsigned n = 2 + next() % 9; n > 0; n--) {
+            word += (char)('a' + next() % 26); }
+    }
+
+    std::string text = "usage: app [options] [--help topic]\n\n";
+    for (int t = 0; t < topicCount; t++) {
+        text += "[[topic" + std::to_string(t) + "]]\n";
+        for (int line = 0; line < 40; line++) {
+            text += "  --option-" + std::to_string(t) + "-" + std::to_string(line) + "   ";
+            for (int w = 0; w < 8; w++) {
+                text += words[next() % words.size()] + (w < 7 ? " " : "\n"); }
+        }
+    }
+    return text;
+}
+
+static std::string localeName(int locale) {
+    return std::string(1, (char)('a' + locale / 26)) + (char)('a' + locale % 26);
+}
+
+static void evict(const std::string& fileName) {
+    int fd = ::open(fileName.c_str(), O_RDONLY);
+    ::fdatasync(fd);
+    ::posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    ::close(fd);
+}
+
+static size_t cachedKiB(const std::string& fileName) {
+    int fd = ::open(fileName.c_str(), O_RDONLY);
+    struct stat st;
+    ::fstat(fd, &st);
+    void* map = ::mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    const size_t page = (size_t)::sysconf(_SC_PAGESIZE), pages = ((size_t)st.st_size + page - 1) / page;
+    std::vector<unsigned char> in(pages);
+    ::mincore(map, (size_t)st.st_size, in.data());
+    ::munmap(map, (size_t)st.st_size);
+    return (size_t)std::count_if(in.begin(), in.end(), [](unsigned char c) { return (c & 1) != 0; }) * page / 1024;
+}
+
+static void run(const std::string& fileName, bool bundle, char** argv, int argc) {
+    if (bundle) {
+        helpHandler::handleBundle(argc, argv, fileName);
+    } else {
+        helpHandler::handleFile(argc, argv, fileName); }
+}
+
+static void report(const char* label, const std::string& fileName, bool bundle, const char* topic) {
+    char name[] = "app", help[] = "--help";
+    char* argv[] = { name, help, const_cast<char*>(topic), nullptr };
+    const int argc = topic ? 3 : 2;
+
+    double p50[2];
+    for (bool cold: { false, true }) {
+        std::vector<double> samples;
+        for (int r = 0; r < (cold ? 30 : 300); r++) {
+            if (cold) {
+                evict(fileName); }
+            const clock_type::time_point start = clock_type::now();
+            run(fileName, bundle, argv, argc);
+            samples.push_back(std::chrono::duration<double, std::micro>(clock_type::now() - start).count());
+        }
+        std::sort(samples.begin(), samples.end());
+        p50[cold] = samples[samples.size() / 2];
+    }
+
+    evict(fileName);
+    run(fileName, bundle, argv, argc);
+    const size_t cached = cachedKiB(fileName);
+
+    //After the runs above, so code pages are already in and only what the call itself maps and allocates counts
+    long mapped, heap;
+    memory(mapped, heap);
+    run(fileName, bundle, argv, argc);
+
+    std::printf("%-24s warm p50 %7.1f us   cold p50 %7.1f us   page cache %5zu KiB   mapped +%4ld KiB   heap +%4ld KiB\n",
+                label, p50[0], p50[1], cached, mappedAtWrite - mapped, heapAtWrite - heap);
+}
+
+
+
+
+int main() {
+    ::mkdir(directory, 0755);
+    helpHandler::bundleWriter writer;
+    size_t looseBytes = 0;
+    for (int l = 0; l < localeCount; l++) {
+        const std::string text = localeText(l);
+        writer.add(localeName(l), text);
+        FILE* fp = std::fopen((std::string(directory) + "/help." + localeName(l) + ".txt").c_str(), "wb");
+        std::fwrite(text.data(), 1, text.size(), fp);
+        std::fclose(fp);
+        looseBytes += text.size();
+    }
+    const std::string bundleFile = std::string(directory) + "/help.hhb";
+    writer.save(bundleFile);
+    struct stat st;
+    ::stat(bundleFile.c_str(), &st);
+    std::printf("%d locales: %zu KiB as loose files or string literals, %lld KiB as a bundle\n\n",
+                localeCount, looseBytes / 1024, (long long)st.st_size / 1024);
+
+    helpHandler::info("app", "1.0");
+    helpHandler::output(helpHandler::sink(copy, nullptr));
+    ::setenv("LANG", (localeName(17) + "_XX.UTF-8").c_str(), 1);
+    report("loose file, --help", std::string(directory) + "/help." + localeName(17) + ".txt", false, nullptr);
+    report("bundle, --help", bundleFile, true, nullptr);
+    report("bundle, --help topic", bundleFile, true, "topic23");
+
+    for (int l = 0; l < localeCount; l++) {
+        ::unlink((std::string(directory) + "/help." + localeName(l) + ".txt").c_str()); }
+    ::unlink(bundleFile.c_str());
+    ::rmdir(directory);
+    return 0;
+}
@@ -0,0 +1,65 @@
+/*
+ * Spawn-to-exit latency of a program doing nothing but info() and handle(), built with and without
+ * HELP_HANDLER_MINIMAL, next to an empty main(). Build it three times and run any of them with --bench:
+ *
+ * g++ -std=c++11 -O2 -s -DEMPTY coldstart.cpp -o empty && g++ -std=c++11 -O2 -s coldstart.cpp -o full
+ * g++ -std=c++11 -O2 -s -DHELP_HANDLER_MINIMAL coldstart.cpp -o minimal
+ * ./full --bench ./empty ./full ./minimal
+ */
+#include "../helpHandler.hpp"
+
+
+#include <chrono>
+#include <vector>
+#include <algorithm>
+#include <spawn.h>
+#include <sys/wait.h>
+
+extern char** environ;
+
+
+
+
+static void run(const char* path, const char* arg, unsigned iterations, std::vector<double>& samples) {
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_addopen(&actions, 1, "/dev/null", O_WRONLY, 0);
+
+    char* args[] = { const_cast<char*>(path), const_cast<char*>(arg), nullptr };
+    samples.clear();
+    for (unsigned i = 0; i < iterations; i++) {
+        auto start = std::chrono::steady_clock::now();
+        pid_t pid;
+        int status;
+        if (posix_spawn(&pid, path, &actions, nullptr, args, environ) != 0) {
+            std::perror(path);
+            std::exit(EXIT_FAILURE); }
+        waitpid(pid, &status, 0);
+        samples.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count());
+    }
+    posix_spawn_file_actions_destroy(&actions);
+    std::sort(samples.begin(), samples.end());
+}
+
+int main(int argc, char** argv) {
+    if (argc > 2 && std::strcmp(argv[1], "--bench") == 0) {
+        const unsigned iterations = 500;
+        const char* cases[] = { "build", "--version" };
+        std::vector<double> samples;
+        for (int i = 2; i < argc; i++) {
+            for (const char* arg : cases) {
+                run(argv[i], arg, 20, samples); //Warm the page cache
+                run(argv[i], arg, iterations, samples);
+                std::printf("%-10s %-10s spawn-to-exit: p50 %8.1f us, p99 %8.1f us\n",
+                            argv[i], arg, samples[samples.size() / 2], samples[samples.size() * 99 / 100]); }
+        }
+        return EXIT_SUCCESS;
+    }
+
+    #ifndef EMPTY
+    helpHandler::info("bench", "1.0");
+    return helpHandler::handle(argc, argv, "usage: bench") < 0 ? EXIT_FAILURE : EXIT_SUCCESS;
+    #else
+    return EXIT_SUCCESS;
+    #endif
+}
@@ -0,0 +1,65 @@
+/*
+ * Exec-to-exit latency of "--version" with and without HELP_HANDLER_EARLY_EXIT, for a program that does
+ * ~50ms of static initialisation before main(). Build it twice and run either binary with --bench:
+ *
+ * g++ -std=c++11 -O2 early_exit.cpp -o late && g++ -std=c++11 -O2 -DEARLY early_exit.cpp -o early
+ * ./late --bench ./late ./early
+ */
+#include "../helpHandler.hpp"
+
+
+#include <chrono>
+#include <vector>
+#include <algorithm>
+#include <sys/wait.h>
+
+
+#ifdef EARLY
+HELP_HANDLER_EARLY_EXIT("bench", "1.0", "usage: bench");
+#endif
+
+//Stands in for plugin loading, JIT caches and large static tables
+static struct heavy_t {
+    std::vector<unsigned> table;
+    heavy_t() : table(1 << 24) {
+        for (size_t i = 0; i < table.size(); i++) {
+            table[i] = (unsigned)(i * 2654435761u); }
+    }
+} heavy_t;
+
+
+
+
+static double run(const char* path, unsigned iterations, std::vector<double>& samples) {
+    samples.clear();
+    for (unsigned i = 0; i < iterations; i++) {
+        auto start = std::chrono::steady_clock::now();
+        pid_t pid = fork();
+        if (pid == 0) {
+            int devnull = open("/dev/null", O_WRONLY);
+            dup2(devnull, 1);
+            execl(path, path, "--version", (char*)nullptr);
+            _exit(127); }
+
+        int status;
+        waitpid(pid, &status, 0);
+        samples.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count());
+    }
+
+    std::sort(samples.begin(), samples.end());
+    return samples[samples.size() / 2];
+}
+
+int main(int argc, char** argv) {
+    if (argc == 4 && std::strcmp(argv[1], "--bench") == 0) {
+        const unsigned iterations = 50;
+        std::vector<double> samples;
+        for (int i = 2; i < 4; i++) {
+            double p50 = run(argv[i], iterations, samples);
+            std::printf("%-10s --version exec-to-exit: p50 %9.1f us, p99 %9.1f us\n", argv[i], p50, samples[samples.size() * 99 / 100]); }
+        return EXIT_SUCCESS;
+    }
+
+    helpHandler::info("bench", "1.0");
+    return helpHandler::handle(argc, argv, "usage: bench") < 0 ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,62 @@
+#!/bin/sh
+# Checks that including helpHandler.hpp adds no dynamic initialisers or exit-time destructors: a program of two
+# translation units that only include the header has to come out with as many .init_array and .fini_array entries as
+# an empty program of two, and with initialiser functions of the same size. <iostream> brings a std::ios_base::Init
+# into every translation unit before GCC 13, so outside the minimal build the empty program's units include <iostream>
+# too. GCC folds all of a unit's initialisers into one function, which is why the entry count alone can't tell an
+# initialiser of the header's apart from that one. CXXFLAGS is passed to every build, so the minimal build is checked
+# with
+#
+# CXXFLAGS=-DHELP_HANDLER_MINIMAL sh initarray.sh
+#
+# sh initarray.sh (CXX overrides the compiler, g++ by default; needs readelf and nm)
+CXX=${CXX:-g++}
+DIR=$(cd "$(dirname "$0")" && pwd)
+TMP=$(mktemp -d)
+trap 'rm -rf "$TMP"' EXIT
+
+printf '#ifndef HELP_HANDLER_MINIMAL\n#include <iostream>\n#endif\nint main() { return 0; }\n' > "$TMP/base.cpp"
+printf '#ifndef HELP_HANDLER_MINIMAL\n#include <iostream>\n#endif\n' > "$TMP/baseother.cpp"
+printf '#include "%s/../helpHandler.hpp"\nint main() { return 0; }\n' "$DIR" > "$TMP/with.cpp"
+printf '#include "%s/../helpHandler.hpp"\n' "$DIR" > "$TMP/withother.cpp"
+
+#Entries in a section, its size over its entry size, 0 when there's no such section
+entries() {
+    set -- $(readelf -SW "$1" | sed 's/^ *\[ *[0-9]*\]//' | awk -v name="$2" '$1 == name { print $5, $6 }')
+    if [ $# -eq 2 ] && [ $((0x$2)) -gt 0 ]; then echo $((0x$1 / 0x$2)); else echo 0; fi
+}
+
+#Bytes of code in the objects' static initialisation and destruction functions
+initialisers() {
+    total=0
+    for size in $(nm -S --defined-only "$@" | awk '/_GLOBAL__sub_[ID]_|__static_initialization_and_destruction/ { print $2 }'); do
+        total=$((total + 0x$size))
+    done
+    echo $total
+}
+
+status=0
+printf '%-6s %-14s %6s %6s\n' level what base with
+for level in -O0 -O2; do
+    for program in base with; do
+        $CXX -std=c++11 $level $CXXFLAGS -c "$TMP/$program.cpp" -o "$TMP/$program.o" || exit 1
+        $CXX -std=c++11 $level $CXXFLAGS -c "$TMP/${program}other.cpp" -o "$TMP/${program}other.o" || exit 1
+        $CXX $level $CXXFLAGS "$TMP/$program.o" "$TMP/${program}other.o" -o "$TMP/$program" || exit 1
+    done
+
+    for what in .init_array .fini_array initialisers; do
+        if [ $what = initialisers ]; then
+            base=$(initialisers "$TMP/base.o" "$TMP/baseother.o")
+            with=$(initialisers "$TMP/with.o" "$TMP/withother.o")
+        else
+            base=$(entries "$TMP/base" $what)
+            with=$(entries "$TMP/with" $what)
+        fi
+        printf '%-6s %-14s %6d %6d\n' $level $what $base $with
+        if [ "$with" -ne "$base" ]; then
+            echo "including the header changes the $what: $base -> $with" >&2
+            status=1
+        fi
+    done
+done
+exit $status
@@ -0,0 +1,47 @@
+/*
+ * Per-call cost of building and emitting a matched response. Output goes to a buffer sink so
+ * only the library's own work is measured, not the terminal
+ *
+ * g++ -std=c++11 -O2 render.cpp -o render && ./render
+ */
+#include "../helpHandler.hpp"
+
+
+#include <chrono>
+
+
+
+
+static double bench(int argc, char** argv, const std::string& help, unsigned iterations) {
+    static char buffer[1 << 16];
+    size_t length = 0;
+    helpHandler::output(helpHandler::sink(buffer, sizeof(buffer), &length));
+
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned i = 0; i < iterations; i++) {
+        length = 0;
+        helpHandler::handle(argc, argv, help); }
+    auto end = std::chrono::steady_clock::now();
+
+    return std::chrono::duration<double, std::nano>(end - start).count() / iterations;
+}
+
+int main() {
+    const unsigned iterations = 1000000;
+    const std::string help = "usage: bench [options] <file>...\n  -h, --help     show this text\n  -v, --version  show the version\n";
+    char* helpArgv[]    = { (char*)"bench", (char*)"--help" };
+    char* versionArgv[] = { (char*)"bench", (char*)"--version" };
+    char* bothArgv[]    = { (char*)"bench", (char*)"--help", (char*)"--version" };
+
+    const char* kinds[] = { "string", "double", "int" };
+    for (int kind = 0; kind < 3; kind++) {
+        if (kind == 0) { helpHandler::info("  bench  ", "1.2.3"); }
+        if (kind == 1) { helpHandler::info("  bench  ", 1.5); }
+        if (kind == 2) { helpHandler::info("  bench  ", 12u); }
+
+        std::printf("%-7s version: help %6.1f ns/call, version %6.1f ns/call, help+version %6.1f ns/call\n", kinds[kind],
+                    bench(2, helpArgv, help, iterations), bench(2, versionArgv, help, iterations), bench(3, bothArgv, help, iterations));
+    }
+
+    return EXIT_SUCCESS;
+}
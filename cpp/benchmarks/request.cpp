@@ -0,0 +1,78 @@
+/*
+ * Cost of request() per call next to handle() into a buffer sink, with operator new counted so any allocation
+ * on the request path shows up. request() should report 0 allocations per call
+ *
+ * g++ -std=c++11 -O2 request.cpp -o request && ./request
+ */
+#include "../helpHandler.hpp"
+
+
+#include <chrono>
+#include <new>
+
+
+
+
+static unsigned long long allocations = 0;
+
+void* operator new(size_t size) {
+    allocations++;
+    if (void* p = std::malloc(size == 0 ? 1 : size)) {
+        return p; }
+    throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+
+
+template<typename Call>
+static void measure(const char* label, unsigned long long calls, Call call) {
+    unsigned long long before = allocations;
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned long long i = 0; i < calls; i++) {
+        call(i); }
+    auto ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+    std::printf("%-28s %8.1f ns/call %8.3f allocs/call\n", label, ns / calls, (double)(allocations - before) / calls);
+}
+
+
+
+
+int main() {
+    const unsigned long long calls = 2000000;
+    const std::string help = "usage: router [command]\n  -h, --help     show this text\n  -v, --version  show the version\n";
+    const helpHandler::fragment helpView = { help.data(), help.size() };
+    const helpHandler::HelpHandler handler = helpHandler::HelpHandler().withName("router").withVersion(2.5);
+
+    const helpHandler::fragment requests[][3] = {
+        { { "get", 3 },      { "--help", 6 },    { "key", 3 } },
+        { { "--version", 9 }, { "get", 3 },       { "key", 3 } },
+        { { "get", 3 },      { "key", 3 },       { "value", 5 } },
+    };
+    const char* labels[] = { "help", "version", "unmatched" };
+    size_t bytes = 0;
+
+    for (int r = 0; r < 3; r++) {
+        std::string label = std::string("request() ") + labels[r];
+        measure(label.c_str(), calls, [&](unsigned long long) {
+            helpHandler::requestResult result;
+            handler.request(requests[r], 3, helpView, result);
+            for (size_t f = 0; f < result.responseSize; f++) {
+                bytes += result.response[f].size; }
+        });
+    }
+
+    char buffer[512];
+    size_t length = 0;
+    const helpHandler::sink out(buffer, sizeof(buffer), &length);
+    char* argv[] = { (char*)"router", (char*)"get", (char*)"--help", (char*)"key" };
+    measure("handle() help, buffer sink", calls, [&](unsigned long long) {
+        length = 0;
+        handler.handle(4, argv, help, out);
+        bytes += length;
+    });
+
+    std::printf("(%zu bytes of responses)\n", bytes);
+    return 0;
+}
@@ -0,0 +1,31 @@
+#!/bin/sh
+# How much helpHandler.hpp adds to an executable: a program calling info() and handle() against an empty main(),
+# both stripped, at each optimisation level. Pass a byte budget to fail when the -O2 delta goes over it; CXXFLAGS is
+# passed to both builds, so the minimal build's budget is checked with
+#
+# CXXFLAGS=-DHELP_HANDLER_MINIMAL sh size.sh 8192
+#
+# sh size.sh [budget] (CXX overrides the compiler, g++ by default)
+CXX=${CXX:-g++}
+DIR=$(cd "$(dirname "$0")" && pwd)
+TMP=$(mktemp -d)
+trap 'rm -rf "$TMP"' EXIT
+
+printf 'int main() { return 0; }\n' > "$TMP/base.cpp"
+printf '#include "%s/../helpHandler.hpp"\nint main(int argc, char** argv) { helpHandler::info("app", "1.0"); return helpHandler::handle(argc, argv, "usage: app"); }\n' "$DIR" > "$TMP/with.cpp"
+
+status=0
+printf '%-6s %10s %10s %10s\n' level base with delta
+for level in -O0 -O2 -Os; do
+    $CXX -std=c++11 $level $CXXFLAGS -s "$TMP/base.cpp" -o "$TMP/base" || exit 1
+    $CXX -std=c++11 $level $CXXFLAGS -s "$TMP/with.cpp" -o "$TMP/with" || exit 1
+    base=$(wc -c < "$TMP/base")
+    with=$(wc -c < "$TMP/with")
+    printf '%-6s %10d %10d %10d\n' $level $base $with $((with - base))
+
+    if [ -n "$1" ] && [ $level = -O2 ] && [ $((with - base)) -gt "$1" ]; then
+        echo "over budget: $((with - base)) > $1 bytes" >&2
+        status=1
+    fi
+done
+exit $status
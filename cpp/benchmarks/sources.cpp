@@ -0,0 +1,133 @@
+/*
+ * A response file of a million paths, ~51MiB, read three ways: handle() expanding "@file" with --help and --version
+ * on its first two lines (reading stops there), on its last two (read to the end), and on none, then the same file
+ * as newline separated stdin. Next to them, what a launcher would otherwise do: read every line into a
+ * std::vector<std::string> and pass handle() an argv built from it. Reports ms, the most heap in use at once (operator
+ * new and delete are counted) and bytes read (rchar from /proc/self/io, Linux only; "-" elsewhere)
+ *
+ * g++ -std=c++11 -O2 sources.cpp -o sources && ./sources
+ */
+#include "../helpHandler.hpp"
+
+
+#include <chrono>
+#include <new>
+#include <malloc.h>
+
+
+
+
+static const char* responseFile = "/tmp/help_handler_sources.rsp";
+static const int argumentCount = 1000000;
+
+static size_t heap = 0, peakHeap = 0;
+
+void* operator new(size_t size) {
+    void* p = std::malloc(size == 0 ? 1 : size);
+    if (p == nullptr) {
+        throw std::bad_alloc(); }
+    heap += ::malloc_usable_size(p);
+    peakHeap = heap > peakHeap ? heap : peakHeap;
+    return p;
+}
+void operator delete(void* p) noexcept {
+    heap -= p != nullptr ? ::malloc_usable_size(p) : 0;
+    std::free(p);
+}
+void operator delete(void* p, size_t) noexcept { operator delete(p); }
+
+static long long bytesRead() { //-1 when /proc/self/io isn't there
+    FILE* io = std::fopen("/proc/self/io", "r");
+    if (io == nullptr) {
+        return -1; }
+
+    long long value = -1;
+    char line[128];
+    while (std::fgets(line, sizeof(line), io) != nullptr) {
+        if (std::sscanf(line, "rchar: %lld", &value) == 1) {
+            break; }
+    }
+    std::fclose(io);
+    return value;
+}
+
+static void write(const char* head, const char* tail) { //Either may be nullptr
+    FILE* fp = std::fopen(responseFile, "wb");
+    if (head != nullptr) {
+        std::fprintf(fp, "%s\n", head); }
+    for (int i = 0; i < argumentCount - 2; i++) {
+        std::fprintf(fp, "/srv/data/project-%03d/build/release/objects/%07d.o\n", i % 1000, i); }
+    if (tail != nullptr) {
+        std::fprintf(fp, "%s\n", tail); }
+    std::fclose(fp);
+}
+
+static void discard(const helpHandler::fragment*, size_t, void*) {} //Only the matching is measured
+
+//What a launcher would do without sources(): every line in memory, then an argv over them
+static int materialized() {
+    std::vector<std::string> lines;
+    std::ifstream file(responseFile);
+    for (std::string line; std::getline(file, line); ) {
+        lines.push_back(line); }
+
+    std::vector<char*> argv = { const_cast<char*>("app") };
+    for (std::string& line: lines) {
+        argv.push_back(&line[0]); }
+    argv.push_back(nullptr);
+    return helpHandler::handle((int)argv.size() - 1, argv.data(), "usage: app");
+}
+
+template<typename Call>
+static void report(const char* label, Call call) {
+    call(); //Warm the page cache
+    heap = peakHeap = 0; //Only what the call itself allocates, which it frees again before returning
+    const long long before = bytesRead();
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    const int matches = call();
+    const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    const long long read = bytesRead() - before;
+
+    char readText[32] = "-";
+    if (before >= 0) {
+        std::snprintf(readText, sizeof(readText), "%.2f MiB", (double)read / (1 << 20)); }
+    std::printf("%-40s %9.2f ms   peak heap %8zu KiB   read %12s   matches %d\n", label, ms, peakHeap / 1024, readText, matches);
+}
+
+
+
+
+int main() {
+    helpHandler::info("app", "1.0");
+    helpHandler::config(false, false, false);
+    helpHandler::output(helpHandler::sink(discard, nullptr));
+    if (std::freopen("/dev/null", "w", stderr) == nullptr) { //A million argv entries warns that argc is large
+        return 1; }
+    char name[] = "app", at[] = "@/tmp/help_handler_sources.rsp";
+    char* argv[] = { name, at, nullptr };
+
+    const struct { const char* label; const char* head; const char* tail; } files[] = {
+        { "on the first two lines", "--help\n--version", nullptr },
+        { "on the last two lines", nullptr, "--help\n--version" },
+        { "not there", nullptr, "--foo\n--bar" },
+    };
+    for (int f = 0; f < 3; f++) {
+        write(files[f].head, files[f].tail);
+        std::printf("help and version %s\n", files[f].label);
+        helpHandler::sources(helpHandler::responseFiles);
+        report("  handle(), @file", [&]() { return helpHandler::handle(2, argv, "usage: app"); });
+
+        helpHandler::sources(helpHandler::stdinLines);
+        report("  handle(), stdin", [&]() {
+            const int fd = ::open(responseFile, O_RDONLY);
+            ::dup2(fd, 0);
+            ::close(fd);
+            return helpHandler::handle(1, argv, "usage: app"); });
+
+        helpHandler::sources(helpHandler::argvOnly);
+        report("  read into a vector, then handle()", materialized);
+    }
+
+    ::unlink(responseFile);
+    return 0;
+}
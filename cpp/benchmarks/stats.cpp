@@ -0,0 +1,87 @@
+/*
+ * Cost of the instrumentation: ns per call for handle() and handleFile(), and with HELP_HANDLER_STATS the per-phase
+ * breakdown it collected. stats.sh builds it both ways, and checks the disabled build is byte for byte the one
+ * without any instrumentation in the source
+ *
+ * g++ -std=c++11 -O2 stats.cpp -o stats && ./stats
+ * g++ -std=c++11 -O2 -DHELP_HANDLER_STATS stats.cpp -o stats && ./stats
+ */
+#include "../helpHandler.hpp"
+
+
+#include <chrono>
+#include <vector>
+
+
+
+
+static std::vector<char*> makeArgv(std::vector<std::string>& storage, bool matched) {
+    storage = { "stats", "--input=a.txt", "-o", "out.bin", "--jobs=8", "build", "--quiet", "--dry-run", "--force", "-x" };
+    if (matched) {
+        storage.back() = "--help"; } //Last, so the whole argv is scanned
+
+    std::vector<char*> argv;
+    for (auto& arg: storage) {
+        argv.push_back(&arg[0]); }
+    argv.push_back(nullptr);
+    return argv;
+}
+
+template<typename Call>
+static void measure(const char* label, Call call) {
+    #ifdef HELP_HANDLER_STATS
+    helpHandler::resetStatistics();
+    #endif
+
+    double ns = 0;
+    unsigned long long calls = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned long long batch = 1; ns < 2e8; batch *= 2) {
+        for (unsigned long long i = 0; i < batch; i++) {
+            call(); }
+        calls += batch;
+        ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    }
+    std::printf("%-28s %10.1f ns/call", label, ns / calls);
+
+    #ifdef HELP_HANDLER_STATS
+    const helpHandler::stats s = helpHandler::statistics();
+    std::printf("   match %7.1f  file %8.1f  write %8.1f ns   %.0f args  %.0f bytes",
+                (double)s.matchNs / s.calls, (double)s.fileNs / s.calls, (double)s.writeNs / s.calls,
+                (double)s.argsScanned / s.calls, (double)s.bytesWritten / s.calls);
+    #endif
+    std::printf("\n");
+}
+
+
+
+
+int main() {
+    const char* helpFile = "/tmp/help_handler_stats_help.txt";
+    std::string text = "usage: stats [options]\n";
+    while (text.size() < (64 << 10)) {
+        text += "  --option-" + std::to_string(text.size()) + "   does something worth a line of help\n"; }
+    std::ofstream(helpFile, std::ios::binary) << text;
+
+    std::vector<std::string> matchedStorage, unmatchedStorage;
+    std::vector<char*> matched = makeArgv(matchedStorage, true);
+    std::vector<char*> unmatched = makeArgv(unmatchedStorage, false);
+    const int argc = (int)matched.size() - 1;
+
+    helpHandler::info("stats", "1.0");
+    int devNull = open("/dev/null", O_WRONLY);
+    helpHandler::output(helpHandler::sink(devNull));
+
+    #ifdef HELP_HANDLER_STATS
+    std::printf("HELP_HANDLER_STATS on\n");
+    #else
+    std::printf("HELP_HANDLER_STATS off\n");
+    #endif
+    measure("handle unmatched", [&]() { helpHandler::handle(argc, unmatched.data(), "usage: stats"); });
+    measure("handle matched", [&]() { helpHandler::handle(argc, matched.data(), "usage: stats"); });
+    measure("handleFile 64KiB matched", [&]() { helpHandler::handleFile(argc, matched.data(), helpFile); });
+
+    close(devNull);
+    std::remove(helpFile);
+    return 0;
+}
@@ -0,0 +1,28 @@
+#!/bin/sh
+# Checks the instrumentation costs nothing when it isn't enabled: stats.cpp built against helpHandler.hpp has to come
+# out byte for byte the same as built against a copy with every HELP_HANDLER_STAT_*/HELP_HANDLER_PROBE* use blanked
+# out, at -O2 and stripped. Then runs stats.cpp with and without HELP_HANDLER_STATS
+#
+# sh stats.sh (CXX overrides the compiler, g++ by default)
+CXX=${CXX:-g++}
+DIR=$(cd "$(dirname "$0")" && pwd)
+TMP=$(mktemp -d)
+trap 'rm -rf "$TMP"' EXIT
+
+#Blanked rather than deleted, so line numbers stay the same
+mkdir "$TMP/bare" "$TMP/bare/benchmarks"
+sed -E 's/^[[:space:]]*HELP_HANDLER_(STAT_ADD|STAT_START|STAT_TIME|PROBE[12]?)\(.*$//' "$DIR/../helpHandler.hpp" > "$TMP/bare/helpHandler.hpp"
+cp "$DIR/stats.cpp" "$TMP/bare/benchmarks/stats.cpp"
+
+$CXX -std=c++11 -O2 -s "$DIR/stats.cpp" -o "$TMP/off" || exit 1
+$CXX -std=c++11 -O2 -s "$TMP/bare/benchmarks/stats.cpp" -o "$TMP/bare/stats" || exit 1
+$CXX -std=c++11 -O2 -DHELP_HANDLER_STATS "$DIR/stats.cpp" -o "$TMP/on" || exit 1
+
+if cmp -s "$TMP/off" "$TMP/bare/stats"; then
+    echo "disabled build is identical to one without instrumentation ($(wc -c < "$TMP/off") bytes)"
+else
+    echo "disabled build differs from one without instrumentation" >&2
+    exit 1
+fi
+
+"$TMP/off" && "$TMP/on"
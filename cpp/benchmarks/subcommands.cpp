@@ -0,0 +1,147 @@
+/*
+ * Subcommand lookups against 10k registered command paths, three words deep like "remote add" with a level above
+ * each: building the tree, its memory, and resolving argv to a command's help, next to a std::map keyed by the
+ * joined path (which is what a program would otherwise build). Both are checked to agree, then handle() is timed
+ * end to end into a buffer sink
+ *
+ * g++ -std=c++11 -O2 subcommands.cpp -o subcommands && ./subcommands
+ */
+#include "../helpHandler.hpp"
+
+
+#include <map>
+#include <chrono>
+#include <random>
+
+
+
+
+static double nanoseconds(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+}
+
+//A path's help, the map baseline: join argv words until one isn't a command
+static const std::string* mapLookup(const std::map<std::string, std::string>& commands, int argc, char** argv) {
+    const std::string* found = &commands.find("")->second;
+    std::string path;
+    for (int i = 1; i < argc; i++) {
+        if (i > 1) {
+            path += ' '; }
+        path += argv[i];
+        auto at = commands.find(path);
+        if (at == commands.end()) {
+            break; }
+        found = &at->second;
+    }
+    return found;
+}
+
+
+
+
+int main() {
+    const char* verbs[] = { "add", "remove", "list", "show", "set", "get", "sync", "prune", "rename", "edit" };
+    std::mt19937 rng(42);
+
+    //25 groups x 40 objects x 10 verbs = 10000 leaf paths, plus 1025 groups and objects above them
+    std::vector<std::string> paths;
+    for (int g = 0; g < 25; g++) {
+        const std::string group = "group" + std::to_string(g);
+        paths.push_back(group);
+        for (int o = 0; o < 40; o++) {
+            const std::string object = group + " object" + std::to_string(o);
+            paths.push_back(object);
+            for (const char* verb: verbs) {
+                paths.push_back(object + " " + verb); }
+        }
+    }
+    std::vector<std::string> helps;
+    size_t helpBytes = 0;
+    for (const auto& path: paths) {
+        helps.push_back("usage: tool " + path + " [options]\n  --force   do it anyway\n  --dry-run print what would happen");
+        helpBytes += helps.back().size(); }
+
+    auto start = std::chrono::steady_clock::now();
+    helpHandler::commandTree tree;
+    tree.add("", "usage: tool <command>");
+    for (size_t i = 0; i < paths.size(); i++) {
+        tree.add(paths[i], helps[i]); }
+    const double build = nanoseconds(start) / 1000;
+
+    std::map<std::string, std::string> map;
+    map[""] = "usage: tool <command>";
+    size_t mapBytes = 0;
+    for (size_t i = 0; i < paths.size(); i++) {
+        map[paths[i]] = helps[i];
+        mapBytes += 48 + 2 * 32 + paths[i].capacity() + helps[i].capacity(); } //Node header and two strings, an estimate
+
+    //argv for "tool <path> --help", with one in four asking about a command that doesn't exist under a real one
+    std::vector<std::vector<std::string>> queries;
+    for (size_t i = 0; i < 4096; i++) {
+        std::vector<std::string> words = { "tool" };
+        const std::string& path = paths[rng() % paths.size()];
+        for (size_t start = 0, end; start < path.size(); start = end + 1) {
+            end = path.find(' ', start);
+            words.push_back(path.substr(start, end == std::string::npos ? std::string::npos : end - start));
+            if (end == std::string::npos) {
+                break; }
+        }
+        if (i % 4 == 0) {
+            words.back() = "missing"; }
+        words.push_back("--help");
+        queries.push_back(words);
+    }
+    std::vector<std::vector<char*>> argvs;
+    for (auto& words: queries) {
+        std::vector<char*> argv;
+        for (auto& word: words) {
+            argv.push_back(&word[0]); }
+        argv.push_back(nullptr);
+        argvs.push_back(argv);
+    }
+
+    const int rounds = 100;
+    size_t mismatches = 0;
+    volatile size_t keep = 0; //So the loops aren't optimised away
+    for (auto& argv: argvs) {
+        helpHandler::fragment help, version;
+        tree.resolve((int)argv.size() - 1, argv.data(), help, version);
+        const std::string* expected = mapLookup(map, (int)argv.size() - 1, argv.data());
+        if (std::string(help.data, help.size) != *expected) {
+            mismatches++; }
+    }
+
+    start = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; r++) {
+        for (auto& argv: argvs) {
+            helpHandler::fragment help, version;
+            keep = (size_t)tree.resolve((int)argv.size() - 1, argv.data(), help, version) + help.size; }
+    }
+    const double resolve = nanoseconds(start) / (rounds * argvs.size());
+
+    start = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; r++) {
+        for (auto& argv: argvs) {
+            keep = mapLookup(map, (int)argv.size() - 1, argv.data())->size(); }
+    }
+    const double mapped = nanoseconds(start) / (rounds * argvs.size());
+
+    static char buffer[1 << 12];
+    size_t length = 0;
+    helpHandler::info("tool", "1.0");
+    helpHandler::output(helpHandler::sink(buffer, sizeof(buffer), &length));
+    start = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; r++) {
+        for (auto& argv: argvs) {
+            length = 0;
+            helpHandler::handle((int)argv.size() - 1, argv.data(), tree); }
+    }
+    const double handled = nanoseconds(start) / (rounds * argvs.size());
+
+    std::printf("%zu commands, built in %.1f us\n", tree.size(), build);
+    std::printf("  memory   tree %9zu bytes   std::map ~%9zu bytes   (%zu of it help text)\n", tree.memoryUsage(), mapBytes, helpBytes);
+    std::printf("  resolve  tree %9.1f ns      std::map  %9.1f ns   (%zu mismatches)\n", resolve, mapped, mismatches);
+    std::printf("  handle() into a buffer %.1f ns\n", handled);
+    (void)keep;
+    return mismatches == 0 ? 0 : 1;
+}
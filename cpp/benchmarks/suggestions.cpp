@@ -0,0 +1,113 @@
+/*
+ * "Did you mean" lookups against 5k and 20k generated option names: building the index, loading it from a blob, and
+ * looking up misspelt and made up arguments, next to a linear scan computing every distance. The tree's answers are
+ * checked against the scan's
+ *
+ * g++ -std=c++11 -O2 suggestions.cpp -o suggestions && ./suggestions
+ */
+#include "../helpHandler.hpp"
+
+
+#include <chrono>
+#include <random>
+#include <set>
+
+
+
+
+static std::vector<std::string> makeNames(size_t count, std::mt19937& rng) {
+    const char* words[] = { "cache", "build", "release", "target", "output", "input", "config", "verbose", "quiet",
+                            "jobs", "feature", "profile", "remote", "branch", "commit", "merge", "format", "trace",
+                            "debug", "strict", "warn", "log", "color", "path", "mode", "dry", "run", "force" };
+    const size_t wordCount = sizeof(words) / sizeof(words[0]);
+    std::set<std::string> seen;
+    std::vector<std::string> names;
+    while (names.size() < count) {
+        std::string name = "--";
+        name += words[rng() % wordCount];
+        name += "-";
+        name += words[rng() % wordCount];
+        if (rng() % 2) {
+            name += "-" + std::to_string(rng() % 1000); }
+        if (seen.insert(name).second) {
+            names.push_back(name); }
+    }
+    return names;
+}
+
+static std::string misspell(std::string name, std::mt19937& rng) {
+    size_t at = 2 + rng() % (name.size() - 2);
+    switch (rng() % 3) {
+        case 0:  name.erase(at, 1); break;
+        case 1:  name.insert(at, 1, (char)('a' + rng() % 26)); break;
+        default: name[at] = (char)('a' + rng() % 26); break;
+    }
+    return name;
+}
+
+static size_t levenshtein(const std::string& a, const std::string& b) {
+    std::vector<size_t> row(b.size() + 1);
+    for (size_t j = 0; j <= b.size(); j++) {
+        row[j] = j; }
+    for (size_t i = 1; i <= a.size(); i++) {
+        size_t diagonal = row[0];
+        row[0] = i;
+        for (size_t j = 1; j <= b.size(); j++) {
+            size_t above = row[j];
+            row[j] = std::min(std::min(row[j] + 1, row[j-1] + 1), diagonal + (a[i-1] == b[j-1] ? 0 : 1));
+            diagonal = above; }
+    }
+    return row[b.size()];
+}
+
+static double microseconds(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+}
+
+
+
+
+int main() {
+    std::mt19937 rng(42);
+
+    for (size_t count: { 5000, 20000 }) {
+        const std::vector<std::string> names = makeNames(count, rng);
+        std::vector<std::string> queries;
+        for (size_t i = 0; i < 1000; i++) {
+            queries.push_back(i % 4 == 0 ? "--no-such-option-" + std::to_string(i) : misspell(names[rng() % names.size()], rng)); }
+
+        auto start = std::chrono::steady_clock::now();
+        helpHandler::suggestionIndex index;
+        for (const auto& name: names) {
+            index.add(name); }
+        double build = microseconds(start);
+
+        const std::string blob = index.serialize();
+        start = std::chrono::steady_clock::now();
+        helpHandler::suggestionIndex loaded = helpHandler::suggestionIndex::load(blob.data(), blob.size());
+        double load = microseconds(start);
+
+        size_t found = 0, mismatches = 0;
+        start = std::chrono::steady_clock::now();
+        for (const auto& query: queries) {
+            found += loaded.lookup(query).size(); }
+        double lookup = microseconds(start) / queries.size();
+
+        start = std::chrono::steady_clock::now();
+        for (const auto& query: queries) {
+            size_t best = 3;
+            for (const auto& name: names) {
+                best = std::min(best, levenshtein(query, name)); }
+            std::vector<std::string> suggested = loaded.lookup(query, 1);
+            if ((best <= 2) != !suggested.empty() || (!suggested.empty() && levenshtein(query, suggested[0]) != best)) {
+                mismatches++; }
+        }
+        double scan = microseconds(start) / queries.size();
+
+        std::printf("%zu names (%zu byte index)\n", index.size(), blob.size());
+        std::printf("  build %10.1f us   load %8.1f us\n", build, load);
+        std::printf("  lookup %9.2f us   linear scan %8.2f us   (%zu suggestions, %zu mismatches)\n", lookup, scan, found, mismatches);
+    }
+
+    return 0;
+}
@@ -0,0 +1,161 @@
+/*
+ * Regression suite for the startup path: handle() and handleFile() across argc sizes, options, matched and
+ * unmatched argv and help file sizes. Reports ns, operator new calls and read/write syscalls per call
+ * (the syscr/syscw counters from /proc/self/io, Linux only; "-" elsewhere)
+ *
+ * Output goes to /dev/null, so the write syscalls are real but the terminal isn't measured. stderr is silenced
+ * while measuring because argc >= 256 warns on every call
+ *
+ * g++ -std=c++11 -O2 suite.cpp -o suite && ./suite
+ */
+#include "../helpHandler.hpp"
+
+
+#include <chrono>
+#include <new>
+#include <vector>
+
+
+
+
+static unsigned long long allocations = 0;
+
+void* operator new(size_t size) {
+    allocations++;
+    if (void* p = std::malloc(size == 0 ? 1 : size)) {
+        return p; }
+    throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+
+
+static long long syscalls() { //-1 when /proc/self/io isn't there
+    FILE* io = std::fopen("/proc/self/io", "r");
+    if (io == nullptr) {
+        return -1; }
+
+    char line[128];
+    long long total = 0, value;
+    while (std::fgets(line, sizeof(line), io) != nullptr) {
+        if (std::sscanf(line, "syscr: %lld", &value) == 1 || std::sscanf(line, "syscw: %lld", &value) == 1) {
+            total += value; }
+    }
+    std::fclose(io);
+    return total;
+}
+
+struct argvList {
+    std::vector<std::string> storage;
+    std::vector<char*> argv;
+
+    argvList(int argc, bool matched) {
+        storage.push_back("suite");
+        for (int i = 1; i < argc; i++) {
+            storage.push_back("--input=file" + std::to_string(i)); }
+        if (matched && argc > 1) {
+            storage.back() = "--help"; } //Last, so the whole argv is scanned
+
+        for (auto& arg: storage) {
+            argv.push_back(&arg[0]); }
+        argv.push_back(nullptr);
+    }
+};
+
+//Runs in doubling batches until about 100ms have gone by, so slow cases still finish after a single call
+template<typename Call>
+static void measure(const std::string& label, Call call) {
+    std::fflush(stdout);
+    int err = dup(2);
+    int null = open("/dev/null", O_WRONLY);
+    dup2(null, 2);
+
+    unsigned long long allocsBefore = allocations;
+    long long sysBefore = syscalls();
+    auto start = std::chrono::steady_clock::now();
+    unsigned long long calls = 0;
+    double ns = 0;
+    for (unsigned long long batch = 1; ns < 1e8; batch *= 2) {
+        for (unsigned long long i = 0; i < batch; i++) {
+            call(); }
+        calls += batch;
+        ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    }
+    long long sysAfter = syscalls();
+    unsigned long long allocs = allocations - allocsBefore;
+
+    dup2(err, 2);
+    close(err);
+    close(null);
+
+    //Reading /proc/self/io takes two reads, counted once between the snapshots
+    if (sysBefore < 0) {
+        std::printf("%-52s %12.1f %10.2f %10s\n", label.c_str(), ns / calls, (double)allocs / calls, "-");
+    } else {
+        std::printf("%-52s %12.1f %10.2f %10.2f\n", label.c_str(), ns / calls, (double)allocs / calls,
+                    (double)(sysAfter - sysBefore - 2) / calls); }
+}
+
+static std::string writeHelpFile(const char* path, size_t size) {
+    std::string text = "usage: suite [options] <file>...\n";
+    while (text.size() < size) {
+        text += "  --option-" + std::to_string(text.size()) + "   does something worth a line of help\n"; }
+    text.resize(size);
+    text.back() = '\n';
+
+    std::ofstream(path, std::ios::binary) << text;
+    return path;
+}
+
+
+
+
+int main() {
+    const std::string help = "usage: suite [options] <file>...\n  -h, --help     show this text\n  -v, --version  show the version\n";
+    const int sizes[] = { 1, 10, 256, 10000, 100000 };
+    const std::string smallFile = writeHelpFile("/tmp/help_handler_suite_small.txt", 256);
+    const std::string largeFile = writeHelpFile("/tmp/help_handler_suite_large.txt", 1 << 20);
+
+    helpHandler::info("suite", "1.0");
+    int devNull = open("/dev/null", O_WRONLY);
+    helpHandler::output(helpHandler::sink(devNull));
+
+    std::printf("%-52s %12s %10s %10s\n", "case", "ns/call", "allocs", "syscalls");
+    for (int extra = 1; extra >= 0; extra--) {
+        for (int unknown = 0; unknown <= 1; unknown++) {
+            helpHandler::config(extra == 1, true, unknown == 1);
+
+            for (int argc: sizes) {
+                for (int matched = 1; matched >= 0; matched--) {
+                    if (argc == 1 && matched == 0) { continue; } //argc 1 is the no argument help either way
+
+                    argvList args(argc, matched == 1);
+                    char label[128];
+                    std::snprintf(label, sizeof(label), "handle extra=%d unknown=%d argc=%-6d %s",
+                                  extra, unknown, argc, matched ? "matched" : "unmatched");
+                    measure(label, [&]() { helpHandler::handle(argc, args.argv.data(), help); });
+                }
+            }
+        }
+    }
+
+    helpHandler::config();
+    for (int argc: sizes) {
+        for (int matched = 1; matched >= 0; matched--) {
+            if (argc == 1 && matched == 0) { continue; }
+
+            argvList args(argc, matched == 1);
+            for (const std::string* file: { &smallFile, &largeFile }) {
+                char label[128];
+                std::snprintf(label, sizeof(label), "handleFile %s argc=%-6d %s",
+                              file == &smallFile ? "256B" : "1MiB", argc, matched ? "matched" : "unmatched");
+                measure(label, [&]() { helpHandler::handleFile(argc, args.argv.data(), *file); });
+            }
+        }
+    }
+
+    close(devNull);
+    std::remove(smallFile.c_str());
+    std::remove(largeFile.c_str());
+    return 0;
+}
@@ -0,0 +1,67 @@
+/*
+ * Throughput of one shared HelpHandler serving help/version requests from 1..N threads at once.
+ * Each thread has its own buffer sink, so the numbers are the library's, not the terminal's
+ *
+ * g++ -std=c++11 -O2 -pthread threads.cpp -o threads && ./threads
+ */
+#include "../helpHandler.hpp"
+
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+
+
+
+static double run(const helpHandler::HelpHandler& handler, unsigned threads, double seconds) {
+    const std::string help = "usage: admin [command]\n  -h, --help     show this text\n  -v, --version  show the version\n";
+    std::atomic<bool> start(false), stop(false);
+    std::vector<unsigned long long> counts(threads * 8, 0); //Spaced out so counters don't share a cache line
+    std::vector<std::thread> workers;
+
+    for (unsigned t = 0; t < threads; t++) {
+        workers.emplace_back([&, t]() {
+            char* argv[] = { (char*)"admin", (char*)(t % 2 ? "--help" : "--version"), (char*)"session" };
+            char buffer[512];
+            size_t length = 0;
+            helpHandler::sink out(buffer, sizeof(buffer), &length);
+
+            while (start.load() == false) {}
+            unsigned long long n = 0;
+            while (stop.load(std::memory_order_relaxed) == false) {
+                length = 0;
+                handler.handle(3, argv, help, out);
+                n++; }
+            counts[t * 8] = n;
+        });
+    }
+
+    start = true;
+    std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+    stop = true;
+    for (auto& worker: workers) {
+        worker.join(); }
+
+    unsigned long long total = 0;
+    for (unsigned t = 0; t < threads; t++) {
+        total += counts[t * 8]; }
+    return total / seconds;
+}
+
+int main() {
+    const helpHandler::HelpHandler handler = helpHandler::HelpHandler().withName("admin").withVersion("3.4.1");
+    unsigned cores = std::thread::hardware_concurrency();
+    if (cores == 0) { cores = 1; }
+
+    double single = 0;
+    for (unsigned threads = 1; threads <= cores; threads *= 2) {
+        double rate = run(handler, threads, 1.0);
+        if (threads == 1) { single = rate; }
+        std::printf("%3u threads: %12.0f requests/s  (%.2fx)\n", threads, rate, rate / single);
+        if (threads < cores && threads * 2 > cores) { threads = cores / 2; } //Always finish on the full core count
+    }
+
+    return EXIT_SUCCESS;
+}
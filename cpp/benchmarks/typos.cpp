@@ -0,0 +1,74 @@
+/*
+ * Per-argument cost of typo matching next to the DFA alone, and next to the std::regex patterns the DFA replaced
+ * (compiled once here, which is kinder to them than the old code was). Arguments are ordinary options and operands
+ * more than 3 edits from both keywords, so every one goes through the whole path
+ *
+ * g++ -std=c++11 -O2 typos.cpp -o typos && ./typos
+ */
+#include "../helpHandler.hpp"
+
+
+#include <chrono>
+#include <regex>
+#include <vector>
+
+
+
+
+static std::vector<std::string> makeArguments(size_t count) {
+    const char* samples[] = { "--input=file.txt", "-o", "out.bin", "--quiet", "build", "--jobs=8", "-x",
+                              "--dry-run", "--force", "--tag", "--release", "src/main.cpp", "--config", "-j4" };
+    std::vector<std::string> arguments;
+    for (size_t i = 0; i < count; i++) {
+        arguments.push_back(samples[i % (sizeof(samples) / sizeof(samples[0]))]); }
+    return arguments;
+}
+
+template<typename Call>
+static double nsPerArgument(size_t arguments, Call call) {
+    double ns = 0;
+    unsigned long long calls = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned long long batch = 1; ns < 2e8; batch *= 2) {
+        for (unsigned long long i = 0; i < batch; i++) {
+            call(); }
+        calls += batch;
+        ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    }
+    return ns / calls / arguments;
+}
+
+
+
+
+int main() {
+    const std::vector<std::string> arguments = makeArguments(1000);
+    std::vector<helpHandler::fragment> tokens;
+    for (const auto& arg: arguments) {
+        tokens.push_back({ arg.data(), arg.size() }); }
+    const helpHandler::fragment help = { "usage: typos", 12 };
+    size_t sink = 0;
+
+    for (unsigned distance = 0; distance <= helpHandler::maxTypoDistance; distance++) {
+        const helpHandler::HelpHandler handler = helpHandler::HelpHandler().withTypos(distance);
+        double ns = nsPerArgument(tokens.size(), [&]() {
+            helpHandler::requestResult result;
+            handler.request(tokens.data(), tokens.size(), help, result);
+            sink += result.responseSize;
+        });
+        helpHandler::requestResult result;
+        if (handler.request(tokens.data(), tokens.size(), help, result) != 0) {
+            std::printf("an argument matched, so the numbers below are off\n"); }
+        std::printf("DFA, typos %u     %8.2f ns/argument\n", distance, ns);
+    }
+
+    const std::regex helpPattern("-{0,}h{1,}e{1,}l{1,}p{1,}(.*)|-{0,}h{1,}$");
+    const std::regex versionPattern("-{0,}v{1,}e{1,}r{1,}s{1,}i{1,}o{1,}n{1,}(.*)|^-{0,}v$");
+    double ns = nsPerArgument(arguments.size(), [&]() {
+        for (const auto& arg: arguments) {
+            sink += std::regex_match(arg, helpPattern) || std::regex_match(arg, versionPattern); }
+    });
+    std::printf("std::regex        %8.2f ns/argument\n", ns);
+
+    return sink == 42 ? 1 : 0; //Keeps the results alive
+}
@@ -25,58 +25,2185 @@
 #ifndef HELP_HANDLER_HPP
 #define HELP_HANDLER_HPP
 
-#include <regex>
+#include <cerrno>
 #include <limits>
+#include <cstdlib>
+#include <cstdio>
+#include <cstring>
 #include <string>
-#include <fstream>
-#include <iostream>
+#include <new>
+#include <memory>
+#include <vector>
+#include <iterator>
+#include <cstdint>
+#include <algorithm>
 #include <stdexcept>
+#include <functional>
+/*
+ * HELP_HANDLER_MINIMAL trims the header down to the core API (handle, handleFile, handleBundle, info, name, version,
+ * config, output, request and HelpHandler) for size-sensitive executables: no <iostream>/<fstream>, and so no ostream
+ * sinks, no typo matching, no suggestions and no bundleWriter. Everything is inline, so whatever a program doesn't call
+ * isn't compiled into it at all; benchmarks/size.sh checks what's left against a budget
+ */
+#ifndef HELP_HANDLER_MINIMAL
+    #include <fstream>
+    #include <iostream>
+#else
+    #include <ios> //std::ios_base::failure, which handle()/handleFile() still throw
+#endif
+
+//writev() is only available on POSIX, elsewhere fragments are written one at a time
+#if !defined(_WIN32) && (defined(__unix__) || defined(__unix) || (defined(__APPLE__) && defined(__MACH__)))
+    #include <fcntl.h>
+    #include <unistd.h>
+    #include <sys/uio.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #define HELP_HANDLER_POSIX_CPP
+#elif defined(_WIN64) || defined(_WIN32)
+    #include <io.h>
+#endif
+
+//Opt-in instrumentation, none of which is compiled in unless asked for. HELP_HANDLER_STATS keeps per-phase counters
+//and timers for helpHandler::statistics(), HELP_HANDLER_PROBES adds USDT probes (provider help_handler) for bpftrace/perf
+#ifdef HELP_HANDLER_STATS
+    #include <atomic>
+    #include <chrono>
+#endif
+#ifdef HELP_HANDLER_PROBES
+    #include <sys/sdt.h> //systemtap-sdt-dev on Debian/Ubuntu, systemtap-sdt-devel on Fedora
+#endif
+
+
+//Using globals instead of macros to avoid polluting namespace where possible
+static constexpr unsigned int version_str    = 0;
+static constexpr unsigned int version_int    = 1;
+static constexpr unsigned int version_double = 2;
+
+/*
+ * None of the state below has a constructor or destructor that has to run: options_t, render_t and stats_t are
+ * constant-initialised, and the free functions' copies live in static locals of inline functions (global() and
+ * counters()), which makes them one object for the whole program however many TUs include this header. So including
+ * it adds nothing to .init_array or atexit, and everything is already set up for HELP_HANDLER_EARLY_EXIT
+ */
+struct info_t { //Only HelpHandler snapshots keep one, the free functions go by what was rendered last
+    std::string name        = "";
+    std::string versionStr  = "";
+    unsigned int versionInt = 0;
+    double versionDouble    = 0;
+    unsigned int versionMostRecent = 0; //Used to determine which overloaded version function was called last
+};
+
+//Response heads, rendered whenever name or version changes so handle() only has to append the help text. All three
+//are views into one text laid out as "version\n" "version" "name ", so the defaults (no name or version) need no storage
+struct render_t {
+    const char* text   = "\n";
+    size_t versionSize = 0;
+    size_t headSize    = 0; //"name ", 0 without a name
+};
+
+namespace helpHandler { class suggestionIndex; struct argScan; }
+
+struct options_t {
+    bool noArgHelp        = true;
+    bool extraStrings     = true;
+    bool unknownArgHelp   = false;
+    unsigned typoDistance = 0; //Edits tolerated by typo matching, 0 turns it off
+    unsigned argSources   = 0; //helpHandler::argSource bits, where arguments are read from besides argv
+    //Reads a response file (or stdin, for nullptr) into the scan. Only sources() sets it, so a program that never
+    //calls that doesn't link the reader
+    bool (*readArgs)(const char* fileName, const struct options_t& options, helpHandler::argScan& scan) = nullptr;
+    const helpHandler::suggestionIndex* suggestions = nullptr; //Names to suggest for unknown arguments, if any
+};
+
+#ifdef HELP_HANDLER_STATS
+//Relaxed atomics, since HelpHandler instances are dispatched from any number of threads at once
+struct stats_t {
+    std::atomic<unsigned long long> calls{0};
+    std::atomic<unsigned long long> argsScanned{0};
+    std::atomic<unsigned long long> matchNs{0};
+    std::atomic<unsigned long long> fileLoads{0};
+    std::atomic<unsigned long long> fileBytes{0};
+    std::atomic<unsigned long long> fileNs{0};
+    std::atomic<unsigned long long> writes{0};
+    std::atomic<unsigned long long> bytesWritten{0};
+    std::atomic<unsigned long long> writeNs{0};
+};
+
+namespace helpHandler {
+    inline struct stats_t& counters() noexcept {
+        static struct stats_t stats;
+        return stats;
+    }
+}
+
+    #define HELP_HANDLER_STAT_ADD(counter, n) helpHandler::counters().counter.fetch_add((n), std::memory_order_relaxed)
+    #define HELP_HANDLER_STAT_START(timer) const std::chrono::steady_clock::time_point timer = std::chrono::steady_clock::now()
+    #define HELP_HANDLER_STAT_TIME(counter, timer) HELP_HANDLER_STAT_ADD(counter, \
+        (unsigned long long)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - timer).count())
+#else
+    //Arguments aren't evaluated, so a disabled build doesn't even compute what would have been counted
+    #define HELP_HANDLER_STAT_ADD(counter, n) ((void)0)
+    #define HELP_HANDLER_STAT_START(timer) ((void)0)
+    #define HELP_HANDLER_STAT_TIME(counter, timer) ((void)0)
+#endif
+
+#ifdef HELP_HANDLER_PROBES
+    #define HELP_HANDLER_PROBE(name) DTRACE_PROBE(help_handler, name)
+    #define HELP_HANDLER_PROBE1(name, a) DTRACE_PROBE1(help_handler, name, a)
+    #define HELP_HANDLER_PROBE2(name, a, b) DTRACE_PROBE2(help_handler, name, a, b)
+#else
+    #define HELP_HANDLER_PROBE(name) ((void)0)
+    #define HELP_HANDLER_PROBE1(name, a) ((void)0)
+    #define HELP_HANDLER_PROBE2(name, a, b) ((void)0)
+#endif
+
+
+
+
+namespace helpHandler {
+    /****************/
+    /**** OUTPUT ****/
+    /****************/
+    /*
+     * A response is gathered as a list of fragments and handed to the sink in one go, so an fd
+     * sink costs a single writev() and a FILE* or ostream sink a single flush, however many pieces it has
+     */
+    struct fragment {
+        const char* data;
+        size_t size;
+    };
+
+    static constexpr size_t maxFragments = 8;
+
+    //Raw fd output with no stdio or iostream involved, which also makes it usable before main(). Responses never have
+    //more than maxFragments, but a callback or HelpHandler user can pass any number, which go out maxFragments at a time
+    inline bool writeFragments(int fd, const fragment* fragments, size_t count) noexcept {
+        #ifdef HELP_HANDLER_POSIX_CPP
+        for (size_t batch = 0; batch < count; batch += maxFragments) {
+            struct iovec iov[maxFragments];
+            int n = 0;
+            for (size_t i = batch; i < count && i < batch + maxFragments; i++) {
+                if (fragments[i].size == 0) { continue; }
+                iov[n].iov_base = const_cast<char*>(fragments[i].data);
+                iov[n].iov_len  = fragments[i].size;
+                n++; }
+
+            struct iovec* next = iov;
+            while (n > 0) {
+                ssize_t written = ::writev(fd, next, n);
+                if (written < 0) {
+                    if (errno == EINTR) { continue; }
+                    return false; }
+
+                //Partial write, skip past whatever made it out and go again
+                while (n > 0 && (size_t)written >= next->iov_len) {
+                    written -= (ssize_t)next->iov_len;
+                    next++;
+                    n--; }
+                if (n > 0) {
+                    next->iov_base = static_cast<char*>(next->iov_base) + written;
+                    next->iov_len -= (size_t)written; }
+            }
+        }
+        #else
+        for (size_t i = 0; i < count; i++) {
+            const char* data = fragments[i].data;
+            size_t left = fragments[i].size;
+            while (left > 0) {
+                int written = ::_write(fd, data, (unsigned int)left);
+                if (written < 0) {
+                    return false; }
+                data += written;
+                left -= (size_t)written; }
+        }
+        #endif
+
+        return true;
+    }
+
+    class sink {
+    public:
+        typedef void (*callback)(const fragment* fragments, size_t count, void* context);
+
+        constexpr sink() noexcept : type(sinkFd), fd(1) {} //stdout
+        constexpr explicit sink(int fileDescriptor) noexcept : type(sinkFd), fd(fileDescriptor) {}
+        constexpr explicit sink(FILE* file) noexcept : type(sinkFile), file(file) {}
+        #ifndef HELP_HANDLER_MINIMAL
+        constexpr explicit sink(std::ostream& stream) noexcept : type(sinkStream), stream(&stream) {}
+        #endif
+        constexpr sink(char* buffer, size_t capacity, size_t* length) noexcept : type(sinkBuffer), buffer(buffer), capacity(capacity), length(length) {}
+        constexpr sink(callback cb, void* context) noexcept : type(sinkCallback), cb(cb), context(context) {}
+
+        void write(const fragment* fragments, size_t count) const {
+            HELP_HANDLER_PROBE2(write_start, fragmentBytes(fragments, count), count);
+            HELP_HANDLER_STAT_START(start);
+            switch (type) {
+                case sinkFd:       writeFd(fragments, count); break;
+                case sinkFile:     writeFile(fragments, count); break;
+                #ifndef HELP_HANDLER_MINIMAL
+                case sinkStream:   writeStream(fragments, count); break;
+                #else
+                case sinkStream:   break;
+                #endif
+                case sinkBuffer:   writeBuffer(fragments, count); break;
+                case sinkCallback: if (cb) { cb(fragments, count, context); } break;
+            }
+            HELP_HANDLER_STAT_TIME(writeNs, start);
+            HELP_HANDLER_STAT_ADD(writes, 1);
+            HELP_HANDLER_STAT_ADD(bytesWritten, fragmentBytes(fragments, count));
+            HELP_HANDLER_PROBE(write_done);
+        }
+
+    private:
+        enum sinkType { sinkFd = 0, sinkFile, sinkStream, sinkBuffer, sinkCallback }; //sinkStream is never set with HELP_HANDLER_MINIMAL
+
+        sinkType type;
+        int fd                = -1;
+        FILE* file            = nullptr;
+        #ifndef HELP_HANDLER_MINIMAL
+        std::ostream* stream  = nullptr;
+        #endif
+        char* buffer          = nullptr;
+        size_t capacity       = 0;
+        size_t* length        = nullptr;
+        callback cb           = nullptr;
+        void* context         = nullptr;
+
+        static size_t fragmentBytes(const fragment* fragments, size_t count) noexcept { //Only used by the instrumentation
+            size_t total = 0;
+            for (size_t i = 0; i < count; i++) {
+                total += fragments[i].size; }
+            return total;
+        }
+
+        void writeFd(const fragment* fragments, size_t count) const {
+            //Anything the program already put through std::cout/stdio has to go out first to keep ordering
+            if (fd == 1) {
+                #ifndef HELP_HANDLER_MINIMAL
+                std::cout.flush();
+                #endif
+                std::fflush(stdout); }
+
+            if (writeFragments(fd, fragments, count) == false) {
+                throw std::ios_base::failure("Could not write output"); }
+        }
+
+        void writeFile(const fragment* fragments, size_t count) const {
+            for (size_t i = 0; i < count; i++) {
+                std::fwrite(fragments[i].data, 1, fragments[i].size, file); }
+            if (std::fflush(file) == EOF) {
+                throw std::ios_base::failure("Could not write output"); }
+        }
+
+        #ifndef HELP_HANDLER_MINIMAL
+        void writeStream(const fragment* fragments, size_t count) const {
+            for (size_t i = 0; i < count; i++) {
+                stream->write(fragments[i].data, (std::streamsize)fragments[i].size); }
+            stream->flush();
+        }
+        #endif
+
+        void writeBuffer(const fragment* fragments, size_t count) const { //Appends, truncating to capacity. length keeps the untruncated total
+            for (size_t i = 0; i < count; i++) {
+                size_t room = *length < capacity ? capacity - *length : 0;
+                if (room > 0) { //Past capacity, buffer + *length would point past the end
+                    std::memcpy(buffer + *length, fragments[i].data, fragments[i].size < room ? fragments[i].size : room); }
+                *length += fragments[i].size; }
+        }
+    };
+
+
+    /*
+     * Handed to a help provider, which may call it any number of times. Each chunk goes to the sink
+     * before the call returns, so a provider is free to reuse its buffer between chunks
+     */
+    class chunkWriter {
+    public:
+        chunkWriter(const sink& destination, const fragment& head) noexcept : destination(destination), head(head) {}
+
+        void operator()(const char* data, size_t size) const {
+            if (size == 0) { return; }
+
+            if (written == false) { //The head goes out with the first chunk
+                fragment out[] = { head, { data, size } };
+                destination.write(out, 2);
+                written = true;
+            } else {
+                fragment out = { data, size };
+                destination.write(&out, 1); }
+        }
+        void operator()(const std::string& text) const {
+            (*this)(text.data(), text.size());
+        }
+
+        bool wroteAnything() const noexcept { return written; }
+
+    private:
+        const sink& destination;
+        fragment head;
+        mutable bool written = false;
+    };
+
+    typedef std::function<void(const chunkWriter& write)> helpProvider;
+
+
+    #ifndef HELP_HANDLER_MINIMAL
+    /*********************/
+    /**** SUGGESTIONS ****/
+    /*********************/
+    /*
+     * "Did you mean" index over an application's real option names, used for unknown arguments when unknownArgHelp
+     * is on. It's a BK-tree under Levenshtein distance: children are keyed by their distance to their parent, and by
+     * the triangle inequality a lookup within k of a node d away only has to visit the children keyed d-k..d+k, a
+     * small part of the tree. Distances use Myers' bit-parallel algorithm, so names are limited to 64 bytes.
+     *
+     * Nodes live in one flat array and names in one string, so the whole index saves to and loads from a single
+     * blob. Build it once with tools/suggestgen.cpp and load the file or embed the blob, rather than adding thousands
+     * of names on every startup
+     */
+    class suggestionIndex {
+    public:
+        explicit suggestionIndex(unsigned maxDistance = 2) : maxDistance(maxDistance) {}
+
+        //Throws std::runtime_error if data isn't an index written by serialize()/save()
+        static suggestionIndex load(const char* data, size_t size) {
+            const unsigned char* in = (const unsigned char*)data;
+            if (data == nullptr || size < 20 || std::memcmp(data, magic, 4) != 0 || read32(in + 4) != formatVersion) {
+                throw std::runtime_error("Not a suggestion index, or one from another version"); }
+
+            suggestionIndex index(read32(in + 8));
+            const size_t count = read32(in + 12), namesSize = read32(in + 16);
+            if ((size - 20) / 20 < count || size - 20 - count * 20 != namesSize) {
+                throw std::runtime_error("Suggestion index is truncated"); }
+
+            index.nodes.resize(count);
+            for (size_t i = 0; i < count; i++) {
+                const unsigned char* field = in + 20 + i * 20;
+                node& n = index.nodes[i];
+                n = { read32(field), read32(field + 4), read32(field + 8), read32(field + 12), read32(field + 16) };
+
+                //Links only ever point forwards, which keeps lookups from looping on a corrupt file
+                if (n.offset > namesSize || n.length > namesSize - n.offset || n.length > 64
+                    || (n.firstChild != none && (n.firstChild <= i || n.firstChild >= count))
+                    || (n.nextSibling != none && (n.nextSibling <= i || n.nextSibling >= count))) {
+                    throw std::runtime_error("Suggestion index is corrupt"); }
+            }
+            index.names.assign(data + 20 + count * 20, namesSize);
+
+            return index;
+        }
+        static suggestionIndex loadFile(const std::string& fileName) {
+            std::ifstream file(fileName, std::ios::binary);
+            if (!file) {
+                throw std::ios_base::failure("Could not open suggestion index"); }
+
+            std::string data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+            return load(data.data(), data.size());
+        }
+
+        void add(const std::string& name) {
+            if (name.empty() || name.size() > 64) {
+                throw std::invalid_argument("Suggestion names must be 1 to 64 characters"); }
+
+            query q(name);
+            uint32_t at = 0;
+            while (at < nodes.size()) {
+                const uint32_t d = q.distance(names.data() + nodes[at].offset, nodes[at].length);
+                if (d == 0) {
+                    return; } //Already there
+
+                uint32_t child = nodes[at].firstChild, lastChild = none;
+                while (child != none && nodes[child].distance != d) {
+                    lastChild = child;
+                    child = nodes[child].nextSibling; }
+                if (child == none) { //Appended at the end of the sibling list, so every link points forwards
+                    const uint32_t added = (uint32_t)nodes.size();
+                    nodes.push_back({ (uint32_t)names.size(), (uint32_t)name.size(), none, none, d });
+                    (lastChild == none ? nodes[at].firstChild : nodes[lastChild].nextSibling) = added;
+                    names += name;
+                    return; }
+                at = child;
+            }
+
+            nodes.push_back({ 0, (uint32_t)name.size(), none, none, 0 }); //Root
+            names = name;
+        }
+
+        //Registered names within the index's distance of arg, closest first (an exact match comes first of all)
+        std::vector<std::string> lookup(const std::string& arg, size_t limit = 3) const {
+            std::vector<std::string> found;
+            if (arg.empty() || arg.size() > 64 || nodes.empty()) {
+                return found; }
+
+            query q(arg);
+            std::vector<std::pair<uint32_t, uint32_t>> close; //Distance, node
+            std::vector<uint32_t> pending(1, 0);
+            while (!pending.empty()) {
+                const uint32_t at = pending.back();
+                pending.pop_back();
+
+                const uint32_t d = q.distance(names.data() + nodes[at].offset, nodes[at].length);
+                if (d <= maxDistance) {
+                    close.push_back({ d, at }); }
+                for (uint32_t child = nodes[at].firstChild; child != none; child = nodes[child].nextSibling) {
+                    if (nodes[child].distance + maxDistance >= d && nodes[child].distance <= d + maxDistance) {
+                        pending.push_back(child); }
+                }
+            }
+
+            std::sort(close.begin(), close.end());
+            for (size_t i = 0; i < close.size() && i < limit; i++) {
+                found.push_back(names.substr(nodes[close[i].second].offset, nodes[close[i].second].length)); }
+            return found;
+        }
+
+        std::string serialize() const {
+            std::string out(magic, 4);
+            write32(out, formatVersion);
+            write32(out, maxDistance);
+            write32(out, (uint32_t)nodes.size());
+            write32(out, (uint32_t)names.size());
+            for (const node& n: nodes) {
+                write32(out, n.offset);
+                write32(out, n.length);
+                write32(out, n.firstChild);
+                write32(out, n.nextSibling);
+                write32(out, n.distance); }
+            return out + names;
+        }
+        void save(const std::string& fileName) const {
+            std::ofstream file(fileName, std::ios::binary);
+            const std::string data = serialize();
+            if (!file.write(data.data(), (std::streamsize)data.size())) {
+                throw std::ios_base::failure("Could not write suggestion index"); }
+        }
+
+        size_t size() const noexcept { return nodes.size(); }
+
+    private:
+        struct node {
+            uint32_t offset, length; //Into names
+            uint32_t firstChild, nextSibling;
+            uint32_t distance;       //To the parent, which is what the parent's children are keyed by
+        };
+
+        //The Myers pattern bitmasks for one name, reused against every node visited
+        struct query {
+            uint64_t peq[256] = {};
+            size_t size;
+
+            explicit query(const std::string& pattern) : size(pattern.size()) {
+                for (size_t i = 0; i < size; i++) {
+                    peq[(unsigned char)pattern[i]] |= 1ull << i; }
+            }
+
+            uint32_t distance(const char* text, size_t n) const noexcept {
+                const uint64_t last = 1ull << (size - 1);
+                uint64_t vp = ~0ull, vn = 0;
+                uint32_t d = (uint32_t)size;
+                for (size_t j = 0; j < n; j++) {
+                    const uint64_t eq = peq[(unsigned char)text[j]];
+                    const uint64_t d0 = (((eq & vp) + vp) ^ vp) | eq | vn;
+                    uint64_t hp = vn | ~(d0 | vp);
+                    uint64_t hn = vp & d0;
+                    d += (hp & last) ? 1 : 0;
+                    d -= (hn & last) ? 1 : 0;
+                    hp = (hp << 1) | 1;
+                    hn <<= 1;
+                    vp = hn | ~(d0 | hp);
+                    vn = hp & d0;
+                }
+                return d;
+            }
+        };
+
+        static constexpr const char* magic = "HHSI";
+        static constexpr uint32_t formatVersion = 1;
+        static constexpr uint32_t none = 0xffffffff;
+
+        std::vector<node> nodes;
+        std::string names;
+        uint32_t maxDistance;
+
+        static uint32_t read32(const unsigned char* in) noexcept { //Little endian on disk
+            return (uint32_t)in[0] | (uint32_t)in[1] << 8 | (uint32_t)in[2] << 16 | (uint32_t)in[3] << 24;
+        }
+        static void write32(std::string& out, uint32_t value) {
+            const char bytes[] = { (char)(value & 0xff), (char)(value >> 8 & 0xff), (char)(value >> 16 & 0xff), (char)(value >> 24) };
+            out.append(bytes, 4);
+        }
+    };
+    #endif
+
+
+    /*********************/
+    /**** SUBCOMMANDS ****/
+    /*********************/
+    /*
+     * Help and version text per subcommand path, for git-style tools: "tool remote add --help" prints only what was
+     * registered for "remote add". It's a hash trie: nodes are numbered, and one open addressing table maps
+     * (parent, word) to the child, so resolving a path costs one hash and usually one probe per word however many
+     * commands are registered. Nodes, table slots and every string (words, help and version text) sit in three flat
+     * arrays, with no per-node allocation
+     */
+    class commandTree {
+    public:
+        commandTree() : nodes(1, node()), slots(16, slot()) {}
+
+        //path is the words after the program name separated by spaces, "" for the program itself. Commands
+        //without help of their own (including ones only added as part of a longer path) use their parent's,
+        //and the same goes for version; an empty version falls back to the one set with version()/info()
+        void add(const std::string& path, const std::string& help, const std::string& version = "") {
+            if (help.empty()) {
+                throw std::invalid_argument("Subcommand help was given, but is empty"); }
+
+            uint32_t at = 0;
+            for (size_t start = 0, end; start < path.size(); start = end + 1) {
+                end = path.find(' ', start);
+                if (end == std::string::npos) {
+                    end = path.size(); }
+                if (end > start) {
+                    at = child(at, path.data() + start, end - start); }
+            }
+
+            nodes[at].help = store(help);
+            if (!version.empty()) {
+                nodes[at].version = store(version); }
+        }
+
+        //Follows argv[1..] down the tree for as long as each argument is a registered subcommand, stopping at
+        //"--". Returns how many arguments that was, with help and version set to the deepest command's text
+        //(version is empty if no command on the way has one)
+        int resolve(int argc, char** argv, fragment& help, fragment& version) const noexcept {
+            uint32_t at = 0;
+            text helpAt = nodes[0].help, versionAt = nodes[0].version;
+            int depth = 0;
+            if (argv != nullptr) {
+                for (int i = 1; i < argc && argv[i] != nullptr && std::strcmp(argv[i], "--") != 0; i++) {
+                    const uint32_t next = find(at, argv[i], std::strlen(argv[i]));
+                    if (next == none) {
+                        break; }
+
+                    at = next;
+                    depth++;
+                    if (nodes[at].help.length > 0)    { helpAt = nodes[at].help; }
+                    if (nodes[at].version.length > 0) { versionAt = nodes[at].version; }
+                }
+            }
+
+            help    = { strings.data() + helpAt.offset, helpAt.length };
+            version = { strings.data() + versionAt.offset, versionAt.length };
+            return depth;
+        }
+
+        size_t size() const noexcept { return nodes.size() - 1; } //Commands, not counting the program itself
+
+        //Bytes held, for sizing registries with thousands of commands
+        size_t memoryUsage() const noexcept {
+            return sizeof(*this) + nodes.capacity() * sizeof(node) + slots.capacity() * sizeof(slot) + strings.capacity();
+        }
+
+    private:
+        struct text {
+            uint32_t offset = 0, length = 0; //Into strings
+        };
+        struct node {
+            text help, version;
+        };
+        struct slot {
+            uint32_t parent = 0, child = 0; //child 0 (the root, never anyone's child) marks an empty slot
+            uint32_t hash = 0;
+            text word;
+        };
+
+        static constexpr uint32_t none = 0xffffffff;
+
+        std::vector<node> nodes;   //0 is the program itself
+        std::vector<slot> slots;   //Power of two sized, kept under 3/4 full
+        std::string strings;
+        size_t used = 0;
+
+        static uint32_t hash(uint32_t parent, const char* word, size_t size) noexcept { //FNV-1a, seeded with the parent
+            uint32_t h = 2166136261u ^ (parent * 16777619u);
+            for (size_t i = 0; i < size; i++) {
+                h = (h ^ (unsigned char)word[i]) * 16777619u; }
+            return h;
+        }
+
+        text store(const std::string& value) {
+            if (strings.size() + value.size() > 0xffffffffu) {
+                throw std::length_error("Subcommand text is larger than 4GiB"); }
+
+            text stored;
+            stored.offset = (uint32_t)strings.size();
+            stored.length = (uint32_t)value.size();
+            strings += value;
+            return stored;
+        }
+
+        uint32_t find(uint32_t parent, const char* word, size_t size) const noexcept {
+            const uint32_t h = hash(parent, word, size);
+            const size_t mask = slots.size() - 1;
+            for (size_t i = h & mask; slots[i].child != 0; i = (i + 1) & mask) {
+                const slot& s = slots[i];
+                if (s.hash == h && s.parent == parent && s.word.length == size
+                    && std::memcmp(strings.data() + s.word.offset, word, size) == 0) {
+                    return s.child; }
+            }
+            return none;
+        }
+
+        uint32_t child(uint32_t parent, const char* word, size_t size) { //Added if it isn't there yet
+            const uint32_t found = find(parent, word, size);
+            if (found != none) {
+                return found; }
+
+            if ((used + 1) * 4 > slots.size() * 3) {
+                grow(); }
+            const uint32_t added = (uint32_t)nodes.size();
+            slot s;
+            s.parent = parent;
+            s.child  = added;
+            s.hash   = hash(parent, word, size);
+            s.word   = store(std::string(word, size));
+            nodes.push_back(node());
+            place(slots, s);
+            used++;
+            return added;
+        }
+
+        static void place(std::vector<slot>& table, const slot& s) noexcept {
+            const size_t mask = table.size() - 1;
+            size_t i = s.hash & mask;
+            while (table[i].child != 0) {
+                i = (i + 1) & mask; }
+            table[i] = s;
+        }
+
+        void grow() {
+            std::vector<slot> bigger(slots.size() * 2, slot());
+            for (const slot& s: slots) {
+                if (s.child != 0) {
+                    place(bigger, s); }
+            }
+            slots.swap(bigger);
+        }
+    };
+
+
+    /**********************/
+    /**** HELP BUNDLES ****/
+    /**********************/
+    /*
+     * One file holding the help text of every locale, each split into blocks at its [[topic]] lines (see Sectioned
+     * help files) and each block compressed on its own, so handleBundle() decompresses only what it prints: one
+     * block for "--help topic", the locale's blocks in order for plain --help. Blocks are in the LZ4 block format,
+     * decoded by the few lines below rather than a dependency. Little endian throughout:
+     *
+     *   "HHHB" version localeCount entryCount stringsSize defaultLocale     (6 x u32)
+     *   locales: nameOffset nameSize firstEntry entryCount                  (4 x u32 each, sorted by name)
+     *   entries: topicOffset topicSize blockOffset blockSize size skip      (6 x u32 each, in text order per locale)
+     *   strings, then the blocks
+     *
+     * A block's text starts with its [[topic]] line, skip bytes long, so the blocks of a locale decompress back to
+     * exactly the text given to bundleWriter::add(). The first block has topic "" when the text doesn't start with
+     * a marker. Build bundles with tools/helpbundle.cpp or bundleWriter
+     */
+
+    //A [[topic]] line without its line ending, with no whitespace or ] in the topic
+    inline bool isSectionMarker(const char* line, size_t size) noexcept {
+        if (size <= 4 || line[0] != '[' || line[1] != '[' || line[size - 2] != ']' || line[size - 1] != ']') {
+            return false; }
+        for (size_t i = 2; i < size - 2; i++) {
+            if (line[i] == ']' || line[i] == ' ' || line[i] == '\t') {
+                return false; }
+        }
+        return true;
+    }
+
+    //Decodes one LZ4 block of exactly size bytes into out. False if it's corrupt or doesn't fill out exactly
+    inline bool lzDecompress(const unsigned char* in, size_t inSize, char* out, size_t size) noexcept {
+        const unsigned char* const end = in + inSize;
+        size_t at = 0;
+        while (in < end) {
+            const unsigned token = *in++;
+            size_t literals = token >> 4;
+            for (unsigned char more = 255; literals >= 15 && more == 255; literals += more) {
+                if (in == end) { return false; }
+                more = *in++; }
+            if (literals > (size_t)(end - in) || literals > size - at) {
+                return false; }
+            std::memcpy(out + at, in, literals);
+            in += literals;
+            at += literals;
+            if (in == end) { //The last sequence is literals only
+                break; }
+
+            if (end - in < 2) {
+                return false; }
+            const size_t offset = (size_t)in[0] | (size_t)in[1] << 8;
+            in += 2;
+            size_t length = (token & 15) + 4;
+            for (unsigned char more = 255; (token & 15) == 15 && more == 255; length += more) {
+                if (in == end) { return false; }
+                more = *in++; }
+            if (offset == 0 || offset > at || length > size - at) {
+                return false; }
+
+            //Matches may overlap what they produce (offset 1 repeats a byte), so copy forwards
+            const char* from = out + at - offset;
+            if (offset >= length) {
+                std::memcpy(out + at, from, length);
+            } else {
+                for (size_t i = 0; i < length; i++) {
+                    out[at + i] = from[i]; }
+            }
+            at += length;
+        }
+        return at == size;
+    }
+
+    //Read-only view of a bundle in memory, validated up front so lookups can trust every offset
+    class bundleView {
+    public:
+        static constexpr uint32_t none = 0xffffffff;
+
+        //Throws std::runtime_error if data isn't a bundle, or one from another version
+        bundleView(const char* data, size_t size) : data((const unsigned char*)data), size(size) {
+            if (data == nullptr || size < 24 || std::memcmp(data, magic, 4) != 0 || read32(this->data + 4) != formatVersion) {
+                throw std::runtime_error("Not a help bundle, or one from another version"); }
+
+            locales = read32(this->data + 8);
+            entries = read32(this->data + 12);
+            const uint64_t stringsSize = read32(this->data + 16);
+            defaultLocale = read32(this->data + 20);
+            const uint64_t strings = 24 + (uint64_t)locales * 16 + (uint64_t)entries * 24;
+            if (strings + stringsSize > size || (locales > 0 && defaultLocale >= locales)) {
+                throw std::runtime_error("Help bundle is truncated"); }
+
+            for (uint32_t l = 0; l < locales; l++) {
+                const unsigned char* field = locale(l);
+                if ((uint64_t)read32(field) + read32(field + 4) > stringsSize
+                    || (uint64_t)read32(field + 8) + read32(field + 12) > entries) {
+                    throw std::runtime_error("Help bundle is corrupt"); }
+            }
+            for (uint32_t e = 0; e < entries; e++) {
+                const unsigned char* field = entry(e);
+                //An LZ4 sequence can't expand more than 255 times, which also caps what a corrupt size can allocate
+                if ((uint64_t)read32(field) + read32(field + 4) > stringsSize
+                    || (uint64_t)read32(field + 8) + read32(field + 12) > size
+                    || read32(field + 16) > (uint64_t)read32(field + 12) * 255 + 16 || read32(field + 20) > read32(field + 16)) {
+                    throw std::runtime_error("Help bundle is corrupt"); }
+            }
+            this->strings = (const char*)data + strings;
+        }
+
+        //Bytes from the start of the bundle to the end of its strings, all a lookup reads before the blocks
+        static size_t tablesSize(const char* data, size_t size) noexcept {
+            if (size < 24) {
+                return size; }
+            const unsigned char* in = (const unsigned char*)data;
+            const uint64_t tables = 24 + (uint64_t)read32(in + 8) * 16 + (uint64_t)read32(in + 12) * 24 + read32(in + 16);
+            return tables < size ? (size_t)tables : size;
+        }
+
+        uint32_t localeCount() const noexcept { return locales; }
+        fragment localeName(uint32_t l) const noexcept { return text(locale(l)); }
+
+        //The locale for a POSIX locale name like "de_AT.UTF-8@euro": the exact language_territory, then the bare
+        //language, then any locale of that language, then the bundle's default. none if the bundle is empty
+        uint32_t findLocale(const char* name) const noexcept {
+            if (locales == 0) {
+                return none; }
+            if (name == nullptr) {
+                return defaultLocale; }
+
+            const size_t full = std::strcspn(name, ".@"), language = std::strcspn(name, "_.@");
+            uint32_t sameLanguage = none;
+            for (uint32_t l = 0; l < locales; l++) {
+                const fragment n = localeName(l);
+                if (n.size == full && std::memcmp(n.data, name, full) == 0) {
+                    return l; }
+                if (n.size >= language && std::memcmp(n.data, name, language) == 0 && (n.size == language || n.data[language] == '_')
+                    && (sameLanguage == none || n.size == language)) {
+                    sameLanguage = l; }
+            }
+            return sameLanguage != none ? sameLanguage : defaultLocale;
+        }
+
+        //Entries are numbered across the whole bundle, and each locale's are consecutive
+        uint32_t firstEntry(uint32_t l) const noexcept { return read32(locale(l) + 8); }
+        uint32_t entryCount(uint32_t l) const noexcept { return read32(locale(l) + 12); }
+        fragment topic(uint32_t e) const noexcept { return text(entry(e)); }
+        uint32_t textSize(uint32_t e) const noexcept { return read32(entry(e) + 16); }
+        uint32_t blockSize(uint32_t e) const noexcept { return read32(entry(e) + 12); }
+        uint32_t markerSize(uint32_t e) const noexcept { return read32(entry(e) + 20); }
+
+        //The entry of l with this topic, none if it has no such topic
+        uint32_t findTopic(uint32_t l, const char* name) const noexcept {
+            const size_t nameSize = std::strlen(name);
+            for (uint32_t e = firstEntry(l); e < firstEntry(l) + entryCount(l); e++) {
+                const fragment t = topic(e);
+                if (nameSize > 0 && t.size == nameSize && std::memcmp(t.data, name, nameSize) == 0) {
+                    return e; }
+            }
+            return none;
+        }
+
+        //The block's compressed bytes, for callers that want to touch (or prefetch) only those pages
+        fragment block(uint32_t e) const noexcept {
+            return { (const char*)data + read32(entry(e) + 8), read32(entry(e) + 12) };
+        }
+
+        //Decompresses entry e into out, which must have room for textSize(e) bytes
+        bool decompress(uint32_t e, char* out) const noexcept {
+            const fragment b = block(e);
+            return lzDecompress((const unsigned char*)b.data, b.size, out, textSize(e));
+        }
+
+    private:
+        static constexpr const char* magic = "HHHB";
+        static constexpr uint32_t formatVersion = 1;
+
+        const unsigned char* data;
+        size_t size;
+        const char* strings = nullptr;
+        uint32_t locales = 0, entries = 0, defaultLocale = 0;
+
+        const unsigned char* locale(uint32_t l) const noexcept { return data + 24 + (size_t)l * 16; }
+        const unsigned char* entry(uint32_t e) const noexcept { return data + 24 + (size_t)locales * 16 + (size_t)e * 24; }
+        fragment text(const unsigned char* field) const noexcept { return { strings + read32(field), read32(field + 4) }; }
+
+        static uint32_t read32(const unsigned char* in) noexcept {
+            return (uint32_t)in[0] | (uint32_t)in[1] << 8 | (uint32_t)in[2] << 16 | (uint32_t)in[3] << 24;
+        }
+    };
+
+    #ifndef HELP_HANDLER_MINIMAL
+    //Encodes size bytes of in as one LZ4 block: greedy matching over a hash of every position, which is slow next to
+    //lz4 itself but only ever runs when a bundle is built
+    inline std::string lzCompress(const char* in, size_t size) {
+        std::string out;
+        auto length = [&out](size_t n) {
+            for (n -= 15; n >= 255; n -= 255) {
+                out += (char)255; }
+            out += (char)n;
+        };
+        auto sequence = [&](size_t literalsAt, size_t literals, size_t offset, size_t match) {
+            const size_t matchCode = match > 0 ? match - 4 : 0;
+            out += (char)((literals < 15 ? literals : 15) << 4 | (matchCode < 15 ? matchCode : 15));
+            if (literals >= 15) {
+                length(literals); }
+            out.append(in + literalsAt, literals);
+            if (match > 0) {
+                out += (char)(offset & 0xff);
+                out += (char)(offset >> 8);
+                if (matchCode >= 15) {
+                    length(matchCode); }
+            }
+        };
+
+        //The format wants the last match to start 12 bytes before the end and the last 5 bytes to be literals
+        static constexpr unsigned hashBits = 16;
+        std::vector<uint32_t> table((size_t)1 << hashBits, 0); //Position + 1 of the last time a hash was seen
+        auto hash = [in](size_t at) {
+            uint32_t bytes;
+            std::memcpy(&bytes, in + at, 4);
+            return (bytes * 2654435761u) >> (32 - hashBits);
+        };
+        size_t anchor = 0;
+        for (size_t at = 0; size >= 12 && at < size - 12; ) {
+            const uint32_t h = hash(at);
+            const size_t candidate = table[h];
+            table[h] = (uint32_t)(at + 1);
+            if (candidate == 0 || at - (candidate - 1) > 65535 || std::memcmp(in + candidate - 1, in + at, 4) != 0) {
+                at++;
+                continue; }
+
+            const size_t from = candidate - 1;
+            size_t match = 4;
+            while (at + match < size - 5 && in[from + match] == in[at + match]) {
+                match++; }
+            sequence(anchor, at - anchor, at - from, match);
+            for (size_t i = at + 1; i < at + match && i < size - 12; i++) {
+                table[hash(i)] = (uint32_t)(i + 1); }
+            at += match;
+            anchor = at;
+        }
+        sequence(anchor, size - anchor, 0, 0);
+        return out;
+    }
+
+    //Builds a bundle: add() each locale's help text, then serialize() or save(). The first locale added is the
+    //default, used when the environment names none the bundle has
+    class bundleWriter {
+    public:
+        void add(const std::string& locale, const std::string& text) {
+            if (locale.empty() || locale.size() > 64 || locale.find_first_of(" \t\r\n.@") != std::string::npos) {
+                throw std::invalid_argument("Bundle locales must be 1 to 64 characters, without spaces, '.' or '@'"); }
+            if (text.empty() || text.size() > 0xffffffff) {
+                throw std::invalid_argument("Bundle help text must be 1 byte to 4GiB"); }
+            for (const localeText& l: locales) {
+                if (l.name == locale) {
+                    throw std::invalid_argument("Locale was already added to the bundle"); }
+            }
+            locales.push_back({ locale, text });
+        }
+
+        std::string serialize() const {
+            std::vector<size_t> order(locales.size());
+            for (size_t l = 0; l < order.size(); l++) {
+                order[l] = l; }
+            std::sort(order.begin(), order.end(), [this](size_t a, size_t b) { return locales[a].name < locales[b].name; });
+
+            std::string localeTable, strings, blocks;
+            std::vector<entry> entries;
+            uint32_t defaultLocale = 0;
+            for (size_t l = 0; l < order.size(); l++) {
+                const localeText& locale = locales[order[l]];
+                if (order[l] == 0) {
+                    defaultLocale = (uint32_t)l; }
+                write32(localeTable, (uint32_t)strings.size());
+                write32(localeTable, (uint32_t)locale.name.size());
+                write32(localeTable, (uint32_t)entries.size());
+                strings += locale.name;
+
+                //A block per [[topic]] line, starting with the line itself, and one before the first if there's text there
+                const std::string& text = locale.text;
+                const size_t first = entries.size();
+                for (size_t at = 0; at < text.size(); ) {
+                    const size_t end = text.find('\n', at);
+                    const size_t next = end == std::string::npos ? text.size() : end + 1;
+                    size_t lineSize = next - at - (end == std::string::npos ? 0 : 1);
+                    if (lineSize > 0 && text[at + lineSize - 1] == '\r') {
+                        lineSize--; }
+
+                    if (isSectionMarker(text.data() + at, lineSize)) {
+                        entries.push_back({ (uint32_t)strings.size(), (uint32_t)(lineSize - 4), 0, 0, (uint32_t)at, (uint32_t)(next - at) });
+                        strings.append(text, at + 2, lineSize - 4);
+                    } else if (entries.size() == first) {
+                        entries.push_back({ (uint32_t)strings.size(), 0, 0, 0, 0, 0 }); }
+                    at = next;
+                }
+                write32(localeTable, (uint32_t)(entries.size() - first));
+
+                //size holds where each block starts until it's compressed
+                for (size_t e = first; e < entries.size(); e++) {
+                    const size_t at = entries[e].size, end = e + 1 < entries.size() ? entries[e + 1].size : text.size();
+                    const std::string compressed = lzCompress(text.data() + at, end - at);
+                    entries[e].blockOffset = (uint32_t)blocks.size();
+                    entries[e].blockSize = (uint32_t)compressed.size();
+                    entries[e].size = (uint32_t)(end - at);
+                    blocks += compressed;
+                }
+            }
+
+            std::string out(magic, 4);
+            write32(out, formatVersion);
+            write32(out, (uint32_t)locales.size());
+            write32(out, (uint32_t)entries.size());
+            write32(out, (uint32_t)strings.size());
+            write32(out, defaultLocale);
+            out += localeTable;
+            const uint64_t blocksAt = out.size() + entries.size() * 24 + strings.size();
+            if (blocksAt + blocks.size() > 0xffffffff) {
+                throw std::length_error("Help bundles are limited to 4GiB"); }
+            for (const entry& e: entries) {
+                write32(out, e.topicOffset);
+                write32(out, e.topicSize);
+                write32(out, (uint32_t)blocksAt + e.blockOffset);
+                write32(out, e.blockSize);
+                write32(out, e.size);
+                write32(out, e.skip); }
+            return out + strings + blocks;
+        }
+        void save(const std::string& fileName) const {
+            std::ofstream file(fileName, std::ios::binary);
+            const std::string data = serialize();
+            if (!file.write(data.data(), (std::streamsize)data.size())) {
+                throw std::ios_base::failure("Could not write help bundle"); }
+        }
+
+        size_t size() const noexcept { return locales.size(); }
+
+    private:
+        struct localeText {
+            std::string name;
+            std::string text;
+        };
+        struct entry {
+            uint32_t topicOffset, topicSize;
+            uint32_t blockOffset, blockSize;
+            uint32_t size, skip;
+        };
+
+        static constexpr const char* magic = "HHHB";
+        static constexpr uint32_t formatVersion = 1;
+
+        std::vector<localeText> locales;
+
+        static void write32(std::string& out, uint32_t value) {
+            const char bytes[] = { (char)(value & 0xff), (char)(value >> 8 & 0xff), (char)(value >> 16 & 0xff), (char)(value >> 24) };
+            out.append(bytes, 4);
+        }
+    };
+    #endif
+
+
+    /*****************/
+    /**** PRIVATE ****/
+    /*****************/
+    //What the free functions use. Constant-initialised, see the top of the file
+    struct global_t {
+        struct options_t options;
+        struct render_t rendered;
+        sink output;
+        char* text = nullptr; //Owns rendered.text when it didn't fit in fixed, and is never freed after the last change
+        //Where rendered.text goes when it fits, so a version number renders without allocating. Two, so the last
+        //rendering can still be read while the next is laid out
+        char fixed[2][128] = {};
+        const char* notedHelp = nullptr; //The help text HELP_HANDLER_NOTE embedded, if it was used
+    };
+
+    inline struct global_t& global() noexcept {
+        static struct global_t state;
+        return state;
+    }
+
+    inline std::string trim(const std::string& str) { //By pointer rather than find_*_not_of()/substr(), which each cost a libstdc++ import
+        const char* first = str.data();
+        const char* last = first + str.size();
+        while (first != last && *first == ' ') {
+            first++; }
+        if (first == last) {
+            return str; }
+
+        while (last[-1] == ' ') {
+            last--; }
+        return std::string(first, last);
+    }
+
+    //A version number as "%u"/"%g" (what operator<< prints by default) into number, which a double always fits
+    inline fragment versionNumber(unsigned int version, char (&number)[32]) noexcept {
+        const int size = std::snprintf(number, sizeof(number), "%u", version);
+        return { number, size > 0 ? (size_t)size : 0 };
+    } inline fragment versionNumber(double version, char (&number)[32]) noexcept {
+        const int size = std::snprintf(number, sizeof(number), "%g", version);
+        return { number, size > 0 ? (size_t)size : 0 };
+    }
+
+    inline std::string versionText(const struct info_t& info) {
+        char number[32];
+        fragment text;
+        switch (info.versionMostRecent) {
+            case version_int: text = versionNumber(info.versionInt, number); return std::string(text.data, text.size);
+            case version_double: text = versionNumber(info.versionDouble, number); return std::string(text.data, text.size);
+        }
+        return info.versionStr;
+    }
+
+    //Lays out "version\n" "version" "name " in text, which must have room for renderSize() bytes, and points out at it
+    inline size_t renderSize(size_t nameSize, size_t verSize) noexcept {
+        return 2 * verSize + 1 + (nameSize == 0 ? 0 : nameSize + 1);
+    } inline size_t renderSize(const std::string& name, const std::string& ver) noexcept {
+        return renderSize(name.size(), ver.size());
+    }
+    inline void render(const fragment& name, const fragment& ver, char* text, struct render_t& out) noexcept {
+        char* at = text;
+        at = std::copy(ver.data, ver.data + ver.size, at);
+        *at++ = '\n';
+        at = std::copy(ver.data, ver.data + ver.size, at);
+        if (name.size > 0) {
+            at = std::copy(name.data, name.data + name.size, at);
+            *at++ = ' '; }
+
+        out.text        = text;
+        out.versionSize = ver.size;
+        out.headSize    = name.size == 0 ? 0 : name.size + 1;
+    } inline void render(const std::string& name, const std::string& ver, char* text, struct render_t& out) noexcept {
+        render(fragment{ name.data(), name.size() }, fragment{ ver.data(), ver.size() }, text, out);
+    }
+
+    inline fragment versionOnly(const struct render_t& rendered) noexcept {
+        return { rendered.text, rendered.versionSize + 1 };
+    }
+    inline fragment helpVersionHead(const struct render_t& rendered) noexcept {
+        return { rendered.text + rendered.versionSize + 1, rendered.versionSize + rendered.headSize };
+    }
+    inline fragment helpHead(const struct render_t& rendered) noexcept {
+        return { rendered.text + 2 * rendered.versionSize + 1, rendered.headSize };
+    }
+
+    //Re-renders the global heads with one of name/version changed, keeping the other from what was rendered last. In
+    //fixed storage when it fits, otherwise on the heap. False if that allocation failed, leaving the last rendering
+    inline bool renderGlobal(const fragment* name, const fragment* ver) noexcept {
+        struct global_t& state = global();
+        const fragment head = helpHead(state.rendered);
+        const fragment lastName = { head.data, head.size > 0 ? head.size - 1 : 0 };
+        const fragment lastVer  = { state.rendered.text, state.rendered.versionSize };
+        if (name == nullptr) { name = &lastName; }
+        if (ver == nullptr)  { ver = &lastVer; }
+
+        const size_t size = renderSize(name->size, ver->size);
+        char* spare = state.fixed[state.rendered.text == state.fixed[0] ? 1 : 0];
+        char* text = size <= sizeof(state.fixed[0]) ? spare : new (std::nothrow) char[size];
+        if (text == nullptr) {
+            return false; }
+
+        render(*name, *ver, text, state.rendered);
+        delete[] state.text;
+        state.text = text == spare ? nullptr : text;
+        return true;
+    } inline void renderGlobal(const std::string* name, const std::string* ver) {
+        const fragment nameText = { name != nullptr ? name->data() : nullptr, name != nullptr ? name->size() : 0 };
+        const fragment verText  = { ver != nullptr ? ver->data() : nullptr, ver != nullptr ? ver->size() : 0 };
+        if (renderGlobal(name != nullptr ? &nameText : nullptr, ver != nullptr ? &verText : nullptr) == false) {
+            throw std::bad_alloc(); }
+    }
+
+    //Registers the name and version HELP_HANDLER_NOTE embedded, exactly as the note holds them so helpscan and --version
+    //print the same bytes, and keeps its help text for notedHelp(). desc is "name\0version\0help"
+    inline bool noteInfo(const char* desc) noexcept {
+        const fragment name = { desc, std::strlen(desc) };
+        const fragment ver  = { name.data + name.size + 1, std::strlen(name.data + name.size + 1) };
+        global().notedHelp = ver.data + ver.size + 1;
+        return renderGlobal(&name, &ver);
+    }
+
+
+    /*
+     * Argument matching
+     *
+     * A DFA built at compile time which accepts exactly what the old std::regex patterns did:
+     *   help:    -{0,}h{1,}e{1,}l{1,}p{1,}(.*)  |  -{0,}h{1,}$                (second only with extraStrings)
+     *   version: -{0,}v{1,}e{1,}r{1,}s{1,}i{1,}o{1,}n{1,}(.*)  |  ^-{0,}v$   (second only with extraStrings)
+     * Both patterns share the leading dashes and diverge on the first letter, so one pass decides either.
+     * ECMAScript's '.' doesn't match '\n' or '\r', so those kill the (.*) tail states as well
+     */
+    enum matchResult { matchNone = 0, matchHelp, matchVersion };
+
+    enum dfaState : unsigned char {
+        stateDash = 0, stateH, stateHE, stateHEL, stateHelp,
+        stateV, stateVV, stateVE, stateVR, stateVS, stateVI, stateVO, stateVersion,
+        stateDead, stateCount };
+    enum dfaClass : unsigned char {
+        classDash = 0, classH, classE, classL, classP,
+        classV, classR, classS, classI, classO, classN,
+        classNewline, classOther, classCount };
+
+    static constexpr unsigned char charClass(unsigned char c) {
+        return c == '-' ? classDash : c == 'h' ? classH : c == 'e' ? classE : c == 'l' ? classL : c == 'p' ? classP
+             : c == 'v' ? classV : c == 'r' ? classR : c == 's' ? classS : c == 'i' ? classI : c == 'o' ? classO : c == 'n' ? classN
+             : (c == '\n' || c == '\r') ? classNewline : classOther;
+    }
+
+    //C++11 has no std::index_sequence, so expand 0..255 by hand to build the byte -> class table
+    template<unsigned... I> struct indexList {};
+    template<unsigned N, unsigned... I> struct makeIndexList : makeIndexList<N-1, N-1, I...> {};
+    template<unsigned... I> struct makeIndexList<0, I...> { typedef indexList<I...> type; };
+
+    template<typename T> struct charClassTable;
+    template<unsigned... I> struct charClassTable<indexList<I...>> {
+        static constexpr unsigned char value[sizeof...(I)] = { charClass((unsigned char)I)... };
+    };
+    template<unsigned... I> constexpr unsigned char charClassTable<indexList<I...>>::value[sizeof...(I)];
+
+    typedef charClassTable<makeIndexList<256>::type> charClasses;
+
+    //A class template's static member, like the tables above, so every translation unit shares one copy
+    template<typename T = void> struct dfaTransitions {
+        static constexpr unsigned char D = stateDead;
+        static constexpr unsigned char value[stateCount][classCount] = {
+            //  -           h       e        l         p          v        r        s        i        o        n             \n    other
+            { stateDash,  stateH, D,       D,        D,         stateV,  D,       D,       D,       D,       D,            D,     D            }, //stateDash
+            { D,          stateH, stateHE, D,        D,         D,       D,       D,       D,       D,       D,            D,     D            }, //stateH
+            { D,          D,      stateHE, stateHEL, D,         D,       D,       D,       D,       D,       D,            D,     D            }, //stateHE
+            { D,          D,      D,       stateHEL, stateHelp, D,       D,       D,       D,       D,       D,            D,     D            }, //stateHEL
+            { stateHelp,  stateHelp, stateHelp, stateHelp, stateHelp, stateHelp, stateHelp, stateHelp, stateHelp, stateHelp, stateHelp, D, stateHelp }, //stateHelp (.*)
+            { D,          D,      stateVE, D,        D,         stateVV, D,       D,       D,       D,       D,            D,     D            }, //stateV
+            { D,          D,      stateVE, D,        D,         stateVV, D,       D,       D,       D,       D,            D,     D            }, //stateVV
+            { D,          D,      stateVE, D,        D,         D,       stateVR, D,       D,       D,       D,            D,     D            }, //stateVE
+            { D,          D,      D,       D,        D,         D,       stateVR, stateVS, D,       D,       D,            D,     D            }, //stateVR
+            { D,          D,      D,       D,        D,         D,       D,       stateVS, stateVI, D,       D,            D,     D            }, //stateVS
+            { D,          D,      D,       D,        D,         D,       D,       D,       stateVI, stateVO, D,            D,     D            }, //stateVI
+            { D,          D,      D,       D,        D,         D,       D,       D,       D,       stateVO, stateVersion, D,     D            }, //stateVO
+            { stateVersion, stateVersion, stateVersion, stateVersion, stateVersion, stateVersion, stateVersion, stateVersion, stateVersion, stateVersion, stateVersion, D, stateVersion }, //stateVersion (.*)
+            { D,          D,      D,       D,        D,         D,       D,       D,       D,       D,       D,            D,     D            }, //stateDead
+        };
+    };
+    template<typename T> constexpr unsigned char dfaTransitions<T>::value[stateCount][classCount];
+
+    typedef dfaTransitions<> dfaTable;
+
+    inline matchResult matchState(unsigned char state, bool extraStrings) noexcept {
+        switch (state) {
+            case stateHelp:    return matchHelp;
+            case stateVersion: return matchVersion;
+            case stateH:       return extraStrings ? matchHelp : matchNone;    //-{0,}h{1,}$
+            case stateV:       return extraStrings ? matchVersion : matchNone; //^-{0,}v$
+            default:           return matchNone;
+        }
+    }
+
+    inline matchResult matchArg(const char* arg, bool extraStrings) noexcept {
+        unsigned char state = stateDash;
+        for (const unsigned char* c = (const unsigned char*)arg; *c != '\0' && state != stateDead; c++) {
+            state = dfaTable::value[state][charClasses::value[*c]]; }
+
+        return matchState(state, extraStrings);
+    }
+
+    //Runs size bytes through the DFA from state, so an argument can be matched a piece at a time
+    inline unsigned char matchFrom(unsigned char state, const char* arg, size_t size) noexcept {
+        for (const unsigned char* c = (const unsigned char*)arg, *end = c + size; c != end && state != stateDead; c++) {
+            state = dfaTable::value[state][charClasses::value[*c]]; }
+        return state;
+    } inline matchResult matchArg(const char* arg, size_t size, bool extraStrings) noexcept { //For tokens that aren't NUL terminated
+        return matchState(matchFrom(stateDash, arg, size), extraStrings);
+    }
+
+
+    #ifndef HELP_HANDLER_MINIMAL
+    /*
+     * Typo matching
+     *
+     * Opt-in, and only for arguments the DFA rejected that start with a dash. The argument without its leading dashes
+     * is compared against "help" and "version" by optimal string alignment distance (Levenshtein plus swapping two
+     * adjacent letters, so --hlep and --verison are one edit away). Hyyrö's bit-parallel algorithm keeps a whole column
+     * of the distance table in one word, so each character of the argument costs a few word operations, and arguments
+     * whose length alone puts them out of range never get that far. Case sensitive, like the DFA
+     */
+    static constexpr unsigned maxTypoDistance = 2; //Version's bound, help's is 1
+
+    //Bit i of a keyword's mask for byte c is set when letter i of the keyword is c
+    static constexpr unsigned char keywordMask(const char* keyword, unsigned char c, unsigned i = 0) {
+        return keyword[i] == '\0' ? 0 : (unsigned char)(((unsigned char)keyword[i] == c ? 1u << i : 0u) | keywordMask(keyword, c, i + 1));
+    }
+
+    template<typename T> struct keywordMaskTable;
+    template<unsigned... I> struct keywordMaskTable<indexList<I...>> {
+        static constexpr unsigned char help[sizeof...(I)]    = { keywordMask("help", (unsigned char)I)... };
+        static constexpr unsigned char version[sizeof...(I)] = { keywordMask("version", (unsigned char)I)... };
+    };
+    template<unsigned... I> constexpr unsigned char keywordMaskTable<indexList<I...>>::help[sizeof...(I)];
+    template<unsigned... I> constexpr unsigned char keywordMaskTable<indexList<I...>>::version[sizeof...(I)];
+
+    typedef keywordMaskTable<makeIndexList<256>::type> keywordMasks;
+
+    inline unsigned typoDistance(const unsigned char* masks, size_t m, const char* arg, size_t n) noexcept { //m must be under 8
+        const unsigned long long last = 1ull << (m - 1);
+        unsigned long long vp = ~0ull, vn = 0, d0 = 0, prevEq = 0;
+        unsigned distance = (unsigned)m;
+
+        for (size_t j = 0; j < n; j++) {
+            const unsigned long long eq = masks[(unsigned char)arg[j]];
+            const unsigned long long transposed = ((~d0 & eq) << 1) & prevEq;
+            d0 = (((eq & vp) + vp) ^ vp) | eq | vn | transposed;
+            unsigned long long hp = vn | ~(d0 | vp);
+            unsigned long long hn = vp & d0;
+            distance += (hp & last) ? 1 : 0;
+            distance -= (hn & last) ? 1 : 0;
+            hp = (hp << 1) | 1; //The whole argument has to match, so the top row counts up rather than staying 0
+            hn <<= 1;
+            vp = hn | ~(d0 | hp);
+            vn = hp & d0;
+            prevEq = eq;
+        }
+
+        return distance;
+    }
+
+    inline matchResult matchTypo(const char* arg, size_t size, unsigned maxDistance) noexcept {
+        if (size == 0 || *arg != '-') { //Only options can be mistyped ones, "heap" or "session" are words or file names
+            return matchNone; }
+        while (size > 0 && *arg == '-') {
+            arg++;
+            size--; }
+        if (size == 0) {
+            return matchNone; }
+
+        //No more than a third of the keyword, one typo for help and two for version, or most short options are in reach
+        const unsigned helpMax = maxDistance < 1 ? maxDistance : 1, versionMax = maxDistance < 2 ? maxDistance : 2;
+        unsigned help = maxTypoDistance + 1, version = maxTypoDistance + 1; //Out of reach of either
+        if (size + helpMax >= 4 && size <= 4 + helpMax) {
+            help = typoDistance(keywordMasks::help, 4, arg, size); }
+        if (size + versionMax >= 7 && size <= 7 + versionMax) {
+            version = typoDistance(keywordMasks::version, 7, arg, size); }
+
+        if (help <= helpMax && help < version) {
+            return matchHelp; }
+        if (version <= versionMax && version < help) {
+            return matchVersion; }
+        return matchNone; //Too far from both, or as close to one as the other
+    }
+    #endif
+
+    //Everything handle() and request() match with: the DFA, then typo matching if it's turned on
+    inline matchResult matchOptions(const char* arg, const struct options_t& options) noexcept {
+        matchResult result = matchArg(arg, options.extraStrings);
+        #ifndef HELP_HANDLER_MINIMAL
+        if (result == matchNone && options.typoDistance > 0) {
+            result = matchTypo(arg, std::strlen(arg), options.typoDistance); }
+        #endif
+        return result;
+    } inline matchResult matchOptions(const char* arg, size_t size, const struct options_t& options) noexcept {
+        matchResult result = matchArg(arg, size, options.extraStrings);
+        #ifndef HELP_HANDLER_MINIMAL
+        if (result == matchNone && options.typoDistance > 0) {
+            result = matchTypo(arg, size, options.typoDistance); }
+        #endif
+        return result;
+    }
+
+
+    /*
+     * Help sources
+     *
+     * handle() and handleFile() share dispatch(), and only differ in where the help text comes from.
+     * A source is asked to write head + help + tail once dispatch() knows the help text is needed,
+     * so a help file is never touched when only the version (or nothing) was asked for
+     */
+    struct stringHelp {
+        const std::string& text;
+
+        void write(const sink& out, const fragment& head, const fragment& tail) const {
+            fragment fragments[] = { head, { text.data(), text.size() }, tail };
+            out.write(fragments, 3);
+        }
+    };
+
+    struct textHelp { //A commandTree's text, which it owns
+        fragment text;
+
+        void write(const sink& out, const fragment& head, const fragment& tail) const {
+            fragment fragments[] = { head, text, tail };
+            out.write(fragments, 3);
+        }
+    };
+
+    struct providerHelp { //Only invoked once dispatch() knows the help text is going to be printed
+        const helpProvider& provider;
+
+        void write(const sink& out, const fragment& head, const fragment& tail) const {
+            chunkWriter writer(out, head);
+            if (provider) {
+                provider(writer); }
+            if (writer.wroteAnything() == false) {
+                writer("No usage help is available", 26); }
+
+            out.write(&tail, 1);
+        }
+    };
+
+    /*
+     * Sectioned help files
+     *
+     * A help file can be split into topics with lines of the form [[topic]], and "--help topic", "--help=topic" or
+     * "help:topic" then print only that topic's section (up to the next [[...]] line). Where each section is goes in a
+     * sidecar index, the help file's name plus ".idx", which records the size and modification time (to the nanosecond,
+     * where struct stat has them) of the file it was built from. A stale or missing index is rebuilt the first time a topic is asked for (tools/helpindex.cpp
+     * builds them ahead of time), so after that a topic costs reading the small index and then only the section's
+     * pages. The index built last is also kept in memory, per thread, so where it can't be written the file is still
+     * only scanned once per thread. The C port reads and writes the same index. Without POSIX, or for a topic the file
+     * doesn't have, the whole file is printed as before
+     */
+    #ifdef HELP_HANDLER_POSIX_CPP
+    struct helpSection {
+        size_t offset;
+        size_t length;
+    };
+
+    //The nanoseconds of the file's modification time, 0 where struct stat doesn't have them (then only seconds count)
+    inline long long mtimeNsec(const struct stat& st) noexcept {
+        #if defined(__APPLE__)
+        return (long long)st.st_mtimespec.tv_nsec;
+        #elif defined(__GLIBC__) && !defined(__USE_XOPEN2K8)
+        return (long long)st.st_mtimensec;
+        #elif defined(_POSIX_VERSION) && _POSIX_VERSION >= 200809L
+        return (long long)st.st_mtim.tv_nsec;
+        #else
+        (void)st;
+        return 0;
+        #endif
+    }
+
+    //"help_handler_index 2 <file size> <file mtime> <mtime nanoseconds>" then "<offset> <length> <topic>" per section.
+    //The nanoseconds make a file rewritten within the same second at the same size stale all the same
+    inline std::string buildSectionIndex(const char* data, size_t size, const struct stat& st) {
+        char line[96];
+        std::snprintf(line, sizeof(line), "help_handler_index 2 %llu %lld %lld\n", (unsigned long long)st.st_size,
+                      (long long)st.st_mtime, mtimeNsec(st));
+        std::string index = line;
+
+        const char* topic = nullptr;
+        size_t topicSize = 0, start = 0;
+        for (size_t at = 0; at < size; ) {
+            const char* end = static_cast<const char*>(std::memchr(data + at, '\n', size - at));
+            const size_t next = end ? (size_t)(end - data) + 1 : size;
+            size_t length = next - at - (end ? 1 : 0);
+            if (length > 0 && data[at + length - 1] == '\r') {
+                length--; }
+
+            if (isSectionMarker(data + at, length)) {
+                if (topic != nullptr) {
+                    std::snprintf(line, sizeof(line), "%llu %llu ", (unsigned long long)start, (unsigned long long)(at - start));
+                    index.append(line).append(topic, topicSize).append(1, '\n'); }
+                topic = data + at + 2;
+                topicSize = length - 4;
+                start = next;
+            }
+            at = next;
+        }
+        if (topic != nullptr) {
+            std::snprintf(line, sizeof(line), "%llu %llu ", (unsigned long long)start, (unsigned long long)(size - start));
+            index.append(line).append(topic, topicSize).append(1, '\n'); }
+
+        return index;
+    }
+
+    //1 if topic was found, 0 if the index is current but doesn't have it, -1 if it's stale or not an index
+    inline int lookupSection(const std::string& index, const struct stat& st, const char* topic, helpSection& found) noexcept {
+        unsigned long long size;
+        long long mtime, nsec;
+        int header = 0;
+        if (std::sscanf(index.c_str(), "help_handler_index 2 %llu %lld %lld\n%n", &size, &mtime, &nsec, &header) != 3 || header == 0
+            || size != (unsigned long long)st.st_size || mtime != (long long)st.st_mtime || nsec != mtimeNsec(st)) {
+            return -1; }
+
+        //Topics can't hold spaces, so " topic\n" only ever matches the end of that topic's line
+        const size_t topicSize = std::strlen(topic);
+        if (topicSize == 0 || std::strpbrk(topic, " \t\r\n]") != nullptr) {
+            return 0; }
+        for (size_t at = index.find(topic, (size_t)header); at != std::string::npos; at = index.find(topic, at + 1)) {
+            if (index[at - 1] != ' ' || index.compare(at + topicSize, 1, "\n") != 0) {
+                continue; }
+
+            const size_t line = index.rfind('\n', at) + 1;
+            char* rest;
+            const unsigned long long offset = std::strtoull(index.c_str() + line, &rest, 10);
+            const unsigned long long length = std::strtoull(rest, &rest, 10);
+            if (*rest != ' ' || rest + 1 != index.c_str() + at || offset > size || length > size - offset) {
+                return -1; }
+
+            found = { (size_t)offset, (size_t)length };
+            return 1;
+        }
+        return 0;
+    }
+
+    inline bool readSmallFile(const std::string& fileName, std::string& out) {
+        int fd = ::open(fileName.c_str(), O_RDONLY);
+        if (fd < 0) {
+            return false; }
+
+        char chunk[4096];
+        ssize_t got;
+        while ((got = ::read(fd, chunk, sizeof(chunk))) != 0) {
+            if (got < 0) {
+                if (errno == EINTR) { continue; }
+                ::close(fd);
+                return false; }
+            out.append(chunk, (size_t)got); }
+        ::close(fd);
+        return true;
+    }
+
+    //Writes to a temporary file first so a concurrent reader never sees half an index. The temporary's name is the
+    //process, this call's stack frame and an attempt number, so concurrent writers (threads included) never pick the
+    //same one, and O_EXCL stops one from truncating another's regardless. Failing (a read-only directory, say) leaves
+    //the index in cachedSectionIndex() only
+    inline void writeSectionIndex(const std::string& fileName, const std::string& index) noexcept {
+        char temporary[4096];
+        int fd = -1;
+        for (int attempt = 0; attempt < 8 && fd < 0; attempt++) {
+            const int n = std::snprintf(temporary, sizeof(temporary), "%s.idx.%ld.%p.%d", fileName.c_str(), (long)::getpid(), (void*)&fd, attempt);
+            if (n < 0 || (size_t)n >= sizeof(temporary)) {
+                return; }
+            fd = ::open(temporary, O_WRONLY | O_CREAT | O_EXCL, 0644);
+            if (fd < 0 && errno != EEXIST) {
+                return; }
+        }
+        if (fd < 0) {
+            return; }
+
+        const fragment text = { index.data(), index.size() };
+        const bool written = writeFragments(fd, &text, 1);
+        if (::close(fd) != 0 || written == false || ::rename(temporary, (fileName + ".idx").c_str()) != 0) {
+            ::unlink(temporary); }
+    }
 
+    //The index this thread built last, so a help file whose index can't be written isn't scanned on every call.
+    //Per thread, since HelpHandler::handleFile() doesn't lock
+    struct sectionIndexCache {
+        std::string fileName;
+        std::string index;
+    };
+    inline sectionIndexCache& cachedSectionIndex() noexcept {
+        static thread_local sectionIndexCache cache;
+        return cache;
+    }
 
-//Using globals instead of macros to avoid polluting namespace where possible
-static constexpr unsigned int version_str    = 0;
-static constexpr unsigned int version_int    = 1;
-static constexpr unsigned int version_double = 2;
+    //Where topic is in the help file open as fd, rebuilding the index if it's stale. False if there's no such topic
+    inline bool findSection(const std::string& fileName, int fd, const struct stat& st, const char* topic, helpSection& found) {
+        sectionIndexCache& cache = cachedSectionIndex();
+        if (cache.fileName == fileName) {
+            const int result = lookupSection(cache.index, st, topic, found);
+            if (result >= 0) {
+                return result == 1; }
+        }
 
-static struct info_t {
-    std::string name        = "";
-    std::string versionStr  = "";
-    unsigned int versionInt = 0;
-    double versionDouble    = 0;
-    unsigned int versionMostRecent = 0; //Used to determine which overloaded version function was called last
-} info_t;
+        std::string index;
+        if (readSmallFile(fileName + ".idx", index)) {
+            const int result = lookupSection(index, st, topic, found);
+            if (result >= 0) {
+                return result == 1; }
+        }
 
-static struct options_t {
-    bool noArgHelp      = true;
-    bool extraStrings   = true;
-    bool unknownArgHelp = false;
-} options_t;
+        void* data = ::mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED) {
+            return false; }
+        index = buildSectionIndex(static_cast<const char*>(data), (size_t)st.st_size, st);
+        ::munmap(data, (size_t)st.st_size);
 
+        writeSectionIndex(fileName, index);
+        cache.fileName = fileName;
+        cache.index = std::move(index);
+        return lookupSection(cache.index, st, topic, found) == 1;
+    }
+    #endif
 
+    class fileHelp { //Served straight from a read-only mapping, so memory stays flat however large the file is
+    public:
+        explicit fileHelp(const std::string& fileName) : fileName(fileName) {}
+        fileHelp(const fileHelp&) = delete;
+        fileHelp& operator=(const fileHelp&) = delete;
+        ~fileHelp() {
+            #ifdef HELP_HANDLER_POSIX_CPP
+            if (mapping != nullptr) { ::munmap(mapping, mappingSize); }
+            #endif
+        }
 
+        //Print only this section of the file if it has one, see Sectioned help files
+        void select(const char* name) noexcept {
+            topic = name;
+        }
 
-namespace helpHandler {
-    /*****************/
-    /**** PRIVATE ****/
-    /*****************/
-    static std::string trim(const std::string& str) {
-        size_t first = str.find_first_not_of(' ');
-        if (std::string::npos == first) {
-            return str; }
-            
-        size_t last = str.find_last_not_of(' ');
-        return str.substr(first, (last - first + 1));
+        void write(const sink& out, const fragment& head, const fragment& tail) {
+            load();
+
+            //The file is printed byte for byte, so only add the trailing newline if it doesn't already end with one
+            const char* text = static_cast<const char*>(data);
+            fragment fragments[] = { head, { text, size }, tail };
+            out.write(fragments, size > 0 && text[size-1] == '\n' ? 2 : 3);
+        }
+
+    private:
+        const std::string& fileName;
+        const char* topic = nullptr;
+        void* data  = nullptr; //The whole file, or only the selected section
+        size_t size = 0;
+        #ifdef HELP_HANDLER_POSIX_CPP
+        void* mapping      = nullptr;
+        size_t mappingSize = 0;
+        #endif
+        #ifndef HELP_HANDLER_POSIX_CPP
+        std::string contents;
+        #endif
+
+        void load() {
+            HELP_HANDLER_PROBE1(file_start, fileName.c_str());
+            HELP_HANDLER_STAT_START(start);
+            #ifdef HELP_HANDLER_POSIX_CPP
+            int fd = ::open(fileName.c_str(), O_RDONLY);
+            if (fd < 0) {
+                throw std::ios_base::failure("Could not open file"); }
+
+            struct stat st;
+            if (::fstat(fd, &st) != 0) {
+                ::close(fd);
+                throw std::ios_base::failure("Could not open file"); }
+            if (st.st_size == 0) {
+                ::close(fd);
+                throw std::runtime_error("Given help file is empty"); }
+
+            //Map only the section's pages when a topic was asked for and found
+            helpSection section = { 0, (size_t)st.st_size };
+            if (topic != nullptr && findSection(fileName, fd, st, topic, section) == false) {
+                section = { 0, (size_t)st.st_size }; }
+            const size_t skip = section.offset % (size_t)::sysconf(_SC_PAGESIZE);
+
+            mappingSize = section.length + skip;
+            mapping = mappingSize > 0 ? ::mmap(nullptr, mappingSize, PROT_READ, MAP_PRIVATE, fd, (off_t)(section.offset - skip)) : nullptr;
+            ::close(fd); //The mapping keeps its own reference
+            if (mapping == MAP_FAILED) {
+                mapping = nullptr;
+                throw std::ios_base::failure("Could not map file"); }
+            if (mapping != nullptr) {
+                ::madvise(mapping, mappingSize, MADV_SEQUENTIAL); }
+            data = static_cast<char*>(mapping) + skip;
+            size = section.length;
+            #elif !defined(HELP_HANDLER_MINIMAL)
+            std::ifstream f(fileName, std::ios::in | std::ios::binary);
+            if (!f.is_open()) {
+                throw std::ios_base::failure("Could not open file"); }
+
+            contents.assign(std::istreambuf_iterator<char>(f), std::istreambuf_iterator<char>());
+            if (contents.empty()) {
+                throw std::runtime_error("Given help file is empty"); }
+
+            data = &contents[0];
+            size = contents.size();
+            #else
+            std::FILE* f = std::fopen(fileName.c_str(), "rb"); //Windows mangles newlines in r, so use rb
+            if (f == nullptr) {
+                throw std::ios_base::failure("Could not open file"); }
+
+            char chunk[4096];
+            for (size_t n; (n = std::fread(chunk, 1, sizeof(chunk), f)) > 0; ) {
+                contents.append(chunk, n); }
+            std::fclose(f);
+            if (contents.empty()) {
+                throw std::runtime_error("Given help file is empty"); }
+
+            data = &contents[0];
+            size = contents.size();
+            #endif
+            HELP_HANDLER_STAT_TIME(fileNs, start);
+            HELP_HANDLER_STAT_ADD(fileLoads, 1);
+            HELP_HANDLER_STAT_ADD(fileBytes, size);
+            HELP_HANDLER_PROBE2(file_done, fileName.c_str(), size);
+        }
+    };
+
+    class bundleHelp { //Maps the whole bundle but only reads its tables and the blocks it prints
+    public:
+        explicit bundleHelp(const std::string& fileName) : fileName(fileName) {}
+        bundleHelp(const bundleHelp&) = delete;
+        bundleHelp& operator=(const bundleHelp&) = delete;
+        ~bundleHelp() {
+            #ifdef HELP_HANDLER_POSIX_CPP
+            if (mapping != nullptr) { ::munmap(mapping, mappingSize); }
+            #endif
+        }
+
+        //Print only this topic's block if the locale has one, see Help bundles
+        void select(const char* name) noexcept {
+            topic = name;
+        }
+
+        void write(const sink& out, const fragment& head, const fragment& tail) {
+            const bundleView view = load();
+            const uint32_t locale = view.findLocale(messageLocale());
+            if (locale == bundleView::none || view.entryCount(locale) == 0) {
+                const fragment fragments[] = { head, { "No usage help is available", 26 }, tail };
+                out.write(fragments, 3);
+                return; }
+
+            uint32_t first = view.firstEntry(locale), last = first + view.entryCount(locale), skip = 0;
+            const uint32_t found = topic != nullptr ? view.findTopic(locale, topic) : bundleView::none;
+            if (found != bundleView::none) {
+                first = found;
+                last = found + 1;
+                skip = view.markerSize(found); }
+
+            //A locale's blocks are contiguous, so this is one read instead of a fault per page
+            const fragment from = view.block(first), to = view.block(last - 1);
+            prefetch(from.data, (size_t)(to.data + to.size - from.data));
+
+            size_t size = 0;
+            for (uint32_t e = first; e < last; e++) {
+                size += view.textSize(e); }
+            HELP_HANDLER_STAT_ADD(fileBytes, size);
+            text.resize(size);
+            for (size_t e = first, at = 0; e < last; at += view.textSize((uint32_t)e++)) {
+                if (view.decompress((uint32_t)e, &text[at]) == false) {
+                    throw std::runtime_error("Help bundle is corrupt"); }
+            }
+
+            //Printed byte for byte like a help file, so only add the trailing newline if it doesn't already end with one
+            const fragment fragments[] = { head, { text.data() + skip, size - skip }, tail };
+            out.write(fragments, size > skip && text[size-1] == '\n' ? 2 : 3);
+        }
+
+    private:
+        const std::string& fileName;
+        const char* topic = nullptr;
+        std::string text;
+        #ifdef HELP_HANDLER_POSIX_CPP
+        void* mapping      = nullptr;
+        size_t mappingSize = 0;
+        #else
+        std::string contents;
+        #endif
+
+        //LC_ALL overrides LC_MESSAGES, which overrides LANG, as for gettext
+        static const char* messageLocale() noexcept {
+            for (const char* variable: { "LC_ALL", "LC_MESSAGES", "LANG" }) {
+                const char* value = std::getenv(variable);
+                if (value != nullptr && value[0] != '\0') {
+                    return value; }
+            }
+            return nullptr;
+        }
+
+        void prefetch(const char* at, size_t size) const noexcept {
+            #ifdef HELP_HANDLER_POSIX_CPP
+            const size_t skip = (size_t)(at - static_cast<const char*>(mapping)) % (size_t)::sysconf(_SC_PAGESIZE);
+            ::madvise(const_cast<char*>(at - skip), size + skip, MADV_WILLNEED);
+            #else
+            (void)at;
+            (void)size;
+            #endif
+        }
+
+        bundleView load() {
+            HELP_HANDLER_PROBE1(file_start, fileName.c_str());
+            HELP_HANDLER_STAT_START(start);
+            #ifdef HELP_HANDLER_POSIX_CPP
+            int fd = ::open(fileName.c_str(), O_RDONLY);
+            if (fd < 0) {
+                throw std::ios_base::failure("Could not open file"); }
+
+            struct stat st;
+            if (::fstat(fd, &st) != 0) {
+                ::close(fd);
+                throw std::ios_base::failure("Could not open file"); }
+            mappingSize = (size_t)st.st_size;
+            mapping = mappingSize > 0 ? ::mmap(nullptr, mappingSize, PROT_READ, MAP_PRIVATE, fd, 0) : nullptr;
+            ::close(fd);
+            if (mapping == MAP_FAILED) {
+                mapping = nullptr;
+                throw std::ios_base::failure("Could not map file"); }
+            const char* data = static_cast<const char*>(mapping);
+            const size_t size = mappingSize;
+            if (mapping != nullptr) { //Only the tables and the blocks printed are read, so read those and nothing around them
+                ::madvise(mapping, mappingSize, MADV_RANDOM);
+                prefetch(data, bundleView::tablesSize(data, size)); }
+            #else
+            std::FILE* f = std::fopen(fileName.c_str(), "rb");
+            if (f == nullptr) {
+                throw std::ios_base::failure("Could not open file"); }
+
+            char chunk[4096];
+            for (size_t n; (n = std::fread(chunk, 1, sizeof(chunk), f)) > 0; ) {
+                contents.append(chunk, n); }
+            std::fclose(f);
+            const char* data = contents.data();
+            const size_t size = contents.size();
+            #endif
+            const bundleView view(data, size);
+            HELP_HANDLER_STAT_TIME(fileNs, start);
+            HELP_HANDLER_STAT_ADD(fileLoads, 1);
+            HELP_HANDLER_PROBE2(file_done, fileName.c_str(), size);
+            return view;
+        }
+    };
+
+    #ifndef HELP_HANDLER_MINIMAL
+    //Names the arguments index doesn't know, each with the closest ones it does. Known ones are left alone
+    inline void reportUnknown(int argc, char** argv, const suggestionIndex& index, const sink& out) {
+        static constexpr int maxReported = 10; //It's a cold path, but argv can be enormous
+        std::string report;
+        int reported = 0;
+
+        for (int i = 1; i < argc && reported < maxReported && std::strcmp(argv[i], "--") != 0; i++) {
+            const std::vector<std::string> close = index.lookup(argv[i]);
+            if (!close.empty() && close.front() == argv[i]) {
+                continue; }
+
+            report += "Unknown argument ";
+            report += argv[i];
+            for (size_t c = 0; c < close.size(); c++) {
+                report += c == 0 ? ", did you mean " : c + 1 == close.size() ? " or " : ", ";
+                report += close[c]; }
+            report += close.empty() ? "\n" : "?\n";
+            reported++;
+        }
+
+        if (!report.empty()) {
+            fragment text = { report.data(), report.size() };
+            out.write(&text, 1); }
     }
+    #endif
 
+    //Everything dispatch() has matched so far, from argv and anything read on its behalf
+    struct argScan {
+        unsigned matches  = 0;
+        bool matchedHelp  = false;
+        bool matchedVer   = false;
+        bool wantTopic    = false; //The help argument didn't name a topic itself, so the next argument may
+        bool ended        = false; //Reached "--", everything after is an operand
+        const char* topic = nullptr;
+        unsigned long long streamed = 0; //Arguments read from response files and stdin
+        std::string kept;                //topic, when it came from a read buffer that's about to be reused
 
-    /****************/
-    /**** PUBLIC ****/
-    /****************/
-    int handle(int argc, char** argv, std::string help) {
-        if (help.empty()) {
-            help = "No usage help is available"; }
-        if (argc == 1 && options_t.noArgHelp == true) {
-            std::cout << help << std::endl;
+        bool done() const noexcept {
+            return ended || (matchedHelp && matchedVer && wantTopic == false);
+        }
+
+        //An argv argument, NUL terminated and outliving the scan. "--help topic", "--help=topic" or "help:topic"
+        void add(const char* arg, matchResult result) noexcept {
+            if (wantTopic && arg[0] != '-' && arg[0] != '\0') {
+                topic = arg; }
+            wantTopic = false;
+
+            if (counted(result)) {
+                const char* named = std::strpbrk(arg, ":=");
+                wantTopic = named == nullptr;
+                topic = named != nullptr && named[1] != '\0' ? named + 1 : nullptr; }
+        }
+
+        //One read from a file or stdin, size bytes that are gone by the next read. arg is null for one too long for
+        //the read buffer, which still counts but can't name a topic
+        void add(const char* arg, size_t size, matchResult result) {
+            streamed++;
+            if (wantTopic && arg != nullptr && size > 0 && arg[0] != '-') {
+                keep(arg, size); }
+            wantTopic = false;
+
+            if (counted(result) && arg != nullptr) {
+                const char* named = arg;
+                while (named != arg + size && *named != ':' && *named != '=') {
+                    named++; }
+                wantTopic = named == arg + size;
+                if (named + 1 < arg + size) {
+                    keep(named + 1, (size_t)(arg + size - named - 1)); }
+            }
+        }
+
+    private:
+        //True for the first help argument, the one that may name a topic
+        bool counted(matchResult result) noexcept {
+            if (result == matchNone || (matchedHelp && matchedVer)) { //Past both, only reading on for the topic
+                return false; }
+
+            matches++;
+            const bool first = result == matchHelp && matchedHelp == false;
+            (result == matchHelp ? matchedHelp : matchedVer) = true;
+            return first;
+        }
+
+        void keep(const char* arg, size_t size) {
+            kept.assign(arg, size);
+            topic = kept.c_str();
+        }
+    };
+
+    #ifndef HELP_HANDLER_MINIMAL
+    /*
+     * Argument sources
+     *
+     * Launchers that would go over ARG_MAX pass arguments in a response file ("@args.rsp") or on stdin instead, so
+     * sources() can have dispatch() read those as well. @file arguments are expanded where they stand, in GCC's
+     * syntax (whitespace separated, '' and "" quote, \ escapes the next byte, and a file can name further @files),
+     * and stdin is read after argv, one argument per line or NUL separated. Both go through one fixed-size buffer per
+     * open file, with arguments matched in place rather than copied out, so a million line response file is scanned
+     * in the same memory as a ten line one, and reading stops as soon as help and version have both matched
+     */
+    enum argSource : unsigned {
+        argvOnly      = 0,
+        responseFiles = 1u << 0, //Expand @file arguments. One that can't be opened stays an ordinary argument
+        stdinLines    = 1u << 1, //Also read one argument per line from stdin, unless it's a terminal
+        stdinNul      = 1u << 2, //Also read NUL separated arguments from stdin (find -print0), unless it's a terminal
+    };
+
+    #ifdef HELP_HANDLER_POSIX_CPP
+    typedef int argStream; //read() returns what a pipe has so far rather than waiting for a whole buffer
+    inline argStream stdinStream() noexcept { return 0; }
+    #else
+    typedef std::FILE* argStream;
+    inline argStream stdinStream() noexcept { return stdin; }
+    #endif
+
+    static constexpr bool plainByte(unsigned char c) { //Anything but whitespace, quotes and \ in a response file
+        return c > ' ' && c != '\'' && c != '"' && c != '\\';
+    }
+
+    template<typename T> struct plainByteTable;
+    template<unsigned... I> struct plainByteTable<indexList<I...>> {
+        static constexpr bool value[sizeof...(I)] = { plainByte((unsigned char)I)... };
+    };
+    template<unsigned... I> constexpr bool plainByteTable<indexList<I...>>::value[sizeof...(I)];
+
+    typedef plainByteTable<makeIndexList<256>::type> plainBytes;
+
+    class argReader { //Splits a file or stdin into arguments in one fixed-size buffer
+    public:
+        enum syntax { lines, nulSeparated, responseFile };
+        static constexpr size_t bufferSize = 1 << 16;
+
+        //A response file, which opened() says whether it could be
+        explicit argReader(const char* fileName) : format(responseFile), owned(true) {
+            #ifdef HELP_HANDLER_POSIX_CPP
+            in = ::open(fileName, O_RDONLY);
+            #ifdef POSIX_FADV_SEQUENTIAL
+            if (in >= 0) {
+                ::posix_fadvise(in, 0, 0, POSIX_FADV_SEQUENTIAL); }
+            #endif
+            #else
+            in = std::fopen(fileName, "rb");
+            #endif
+        }
+
+        //A stream it doesn't own, such as stdin. It's put back where it was if it can seek, so the program reads it whole
+        argReader(argStream in, syntax format) : in(in), format(format), owned(false) {
+            #ifdef HELP_HANDLER_POSIX_CPP
+            origin = (long long)::lseek(in, 0, SEEK_CUR);
+            #else
+            origin = (long long)std::ftell(in);
+            #endif
+        }
+
+        ~argReader() {
+            if (opened() == false) {
+                return; }
+
+            #ifdef HELP_HANDLER_POSIX_CPP
+            if (owned) {
+                ::close(in);
+            } else if (origin >= 0) {
+                ::lseek(in, (off_t)origin, SEEK_SET); }
+            #else
+            if (owned) {
+                std::fclose(in);
+            } else if (origin >= 0) {
+                std::fseek(in, (long)origin, SEEK_SET); }
+            #endif
+        }
+
+        argReader(const argReader&) = delete;
+        argReader& operator=(const argReader&) = delete;
+
+        bool opened() const noexcept {
+            #ifdef HELP_HANDLER_POSIX_CPP
+            return in >= 0;
+            #else
+            return in != nullptr;
+            #endif
+        }
+
+        syntax kind() const noexcept { return format; }
+
+        //The next argument, valid until the next call. One that outgrows the buffer comes in pieces, every piece but
+        //the last with complete false. False once the stream is exhausted
+        bool next(fragment& arg, bool& complete) {
+            complete = true;
+            for (;;) {
+                if (format == responseFile ? splitQuoted(arg) : split(arg)) {
+                    return true; }
+
+                if (exhausted) { //Whatever is left is the last argument
+                    const bool left = format == responseFile ? inArg : write > start;
+                    arg = { buffer.get() + start, write - start - (format == lines && left && buffer[write - 1] == '\r' ? 1 : 0) };
+                    start = write;
+                    inArg = false;
+                    return left;
+                }
+
+                //Move the unfinished argument to the front and read more after it, or hand it out if it fills the buffer
+                if (start > 0) {
+                    std::memmove(buffer.get(), buffer.get() + start, write - start);
+                    write -= start;
+                    start = 0; }
+                read = filled = write;
+                if (write == bufferSize) {
+                    arg = { buffer.get(), write };
+                    complete = false;
+                    write = read = filled = 0;
+                    return true;
+                }
+
+                const size_t got = fill(buffer.get() + write, bufferSize - write);
+                exhausted = got == 0;
+                filled += got;
+            }
+        }
+
+    private:
+        argStream in;
+        syntax format;
+        bool owned;
+        long long origin = -1;
+        std::unique_ptr<char[]> buffer{ new char[bufferSize] };
+        size_t start  = 0; //The unfinished argument's first byte
+        size_t write  = 0; //End of its bytes so far, which quotes and escapes can leave behind read
+        size_t read   = 0; //Next byte to look at
+        size_t filled = 0;
+        bool exhausted = false, inArg = false, escaped = false;
+        char quote = 0;
+
+        size_t fill(char* to, size_t size) noexcept {
+            #ifdef HELP_HANDLER_POSIX_CPP
+            for (;;) {
+                const ssize_t got = ::read(in, to, size);
+                if (got >= 0) {
+                    return (size_t)got; }
+                if (errno != EINTR) {
+                    return 0; }
+            }
+            #else
+            return std::fread(to, 1, size, in);
+            #endif
+        }
+
+        bool split(fragment& arg) noexcept {
+            char* data = buffer.get();
+            const char* found = (const char*)std::memchr(data + read, format == lines ? '\n' : '\0', filled - read);
+            if (found == nullptr) {
+                read = write = filled;
+                return false; }
+
+            const size_t end = (size_t)(found - data);
+            arg = { data + start, end - start - (format == lines && end > start && data[end - 1] == '\r' ? 1 : 0) };
+            start = write = read = end + 1;
+            return true;
+        }
+
+        //Whether any of 8 bytes is below '(' or is \, which covers every byte that isn't plain. Exact about there being
+        //none, which is all the caller relies on
+        static bool maybeSpecial(const char* at) noexcept {
+            uint64_t word;
+            std::memcpy(&word, at, 8);
+            const uint64_t ones = 0x0101010101010101ull, highs = 0x8080808080808080ull;
+            const uint64_t backslash = word ^ (ones * '\\');
+            return (((word - ones * '(') & ~word) | ((backslash - ones) & ~backslash)) & highs;
+        }
+
+        //Unquotes in place, which only ever shortens an argument
+        bool splitQuoted(fragment& arg) noexcept {
+            char* data = buffer.get();
+            while (read < filled) {
+                //Bytes that are neither whitespace, quotes nor \ go a run at a time, and stay put until something is unquoted
+                size_t run = read;
+                if (escaped == false && quote == 0) {
+                    while (run + 8 <= filled && maybeSpecial(data + run) == false) {
+                        run += 8; }
+                    while (run < filled && plainBytes::value[(unsigned char)data[run]]) {
+                        run++; }
+                }
+                if (run != read) {
+                    if (write != read) {
+                        std::memmove(data + write, data + read, run - read); }
+                    write += run - read;
+                    read = run;
+                    inArg = true;
+                    continue;
+                }
+
+                const char c = data[read++];
+                if (escaped) {
+                    escaped = false;
+                    data[write++] = c;
+                } else if (c == '\\') {
+                    escaped = inArg = true;
+                } else if (quote != 0) {
+                    if (c == quote) {
+                        quote = 0;
+                    } else {
+                        data[write++] = c; }
+                } else if (c == '\'' || c == '"') {
+                    quote = c;
+                    inArg = true;
+                } else if (c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' || c == '\f') {
+                    const bool ends = inArg;
+                    arg = { data + start, write - start };
+                    start = write = read;
+                    inArg = false;
+                    if (ends) {
+                        return true; }
+                } else {
+                    data[write++] = c;
+                    inArg = true; }
+            }
+            return false;
+        }
+    };
+
+    //@files inside response files are expanded too, but no deeper than this, so files naming each other still end
+    static constexpr unsigned maxSourceDepth = 8;
+
+    inline bool scanResponseFile(const char* fileName, const struct options_t& options, struct argScan& scan, unsigned depth);
+
+    //Matches what reader holds until it runs out or scan is done
+    inline void scanSource(argReader& reader, const struct options_t& options, struct argScan& scan, unsigned depth) {
+        fragment arg;
+        bool complete;
+        unsigned char state = stateDash; //Carried across the pieces of an argument too long for the buffer
+        bool inPieces = false;
+        while (scan.done() == false && reader.next(arg, complete)) {
+            if (complete == false || inPieces) {
+                state = matchFrom(state, arg.data, arg.size);
+                inPieces = complete == false;
+                if (complete) {
+                    scan.add(nullptr, 0, matchState(state, options.extraStrings));
+                    state = stateDash; }
+                continue;
+            }
+
+            if (arg.size == 2 && arg.data[0] == '-' && arg.data[1] == '-') {
+                scan.ended = true;
+                break; }
+            if (arg.size > 1 && arg.data[0] == '@' && reader.kind() == argReader::responseFile && depth < maxSourceDepth
+                && scanResponseFile(std::string(arg.data + 1, arg.size - 1).c_str(), options, scan, depth + 1)) {
+                continue; }
+
+            scan.add(arg.data, arg.size, matchOptions(arg.data, arg.size, options));
+        }
+    }
+
+    //False if fileName can't be opened, which leaves "@fileName" an ordinary argument, as GCC does
+    inline bool scanResponseFile(const char* fileName, const struct options_t& options, struct argScan& scan, unsigned depth) {
+        argReader reader(fileName);
+        if (reader.opened() == false) {
+            return false; }
+
+        scanSource(reader, options, scan, depth);
+        return true;
+    }
+
+    //Only when stdin was asked for and isn't a terminal, which someone would have to end input on before anything printed
+    inline bool readsStdin(const struct options_t& options) noexcept {
+        if ((options.argSources & (stdinLines | stdinNul)) == 0) {
+            return false; }
+        #ifdef HELP_HANDLER_POSIX_CPP
+        return ::isatty(stdinStream()) == 0;
+        #else
+        return true;
+        #endif
+    }
+
+    //options_t::readArgs. Stdin is read after argv, as if appended to it
+    inline bool readArgs(const char* fileName, const struct options_t& options, struct argScan& scan) {
+        if (fileName != nullptr) {
+            return scanResponseFile(fileName, options, scan, 1); }
+
+        argReader reader(stdinStream(), (options.argSources & stdinNul) != 0 ? argReader::nulSeparated : argReader::lines);
+        scanSource(reader, options, scan, 0);
+        return true;
+    }
+    #endif
+
+    //For help sources that have topics: files and bundles
+    template<typename HelpSource>
+    inline void selectTopic(HelpSource&, const char*) noexcept {}
+    inline void selectTopic(fileHelp& help, const char* topic) noexcept {
+        help.select(topic);
+    } inline void selectTopic(bundleHelp& help, const char* topic) noexcept {
+        help.select(topic);
+    }
+
+    //Only reads its arguments, so any number of threads can dispatch against the same options/render at once
+    template<typename HelpSource>
+    inline int dispatch(int argc, char** argv, HelpSource& help, const struct options_t& options, const struct render_t& rendered, const sink& out) {
+        HELP_HANDLER_STAT_ADD(calls, 1);
+        #ifndef HELP_HANDLER_MINIMAL
+        const bool argsOnStdin = readsStdin(options); //Then no arguments in argv isn't the same as none at all
+        #else
+        const bool argsOnStdin = false;
+        #endif
+        if (argc == 1 && options.noArgHelp == true && argsOnStdin == false) {
+            help.write(out, { "", 0 }, { "\n", 1 });
             return EXIT_SUCCESS; }
 
         /****************/
@@ -89,7 +2216,12 @@ namespace helpHandler {
             if (argc > std::numeric_limits<int>::max()) {
                 throw std::invalid_argument("Argument count (argc) is larger than the limit of int type"); }
 
+            #ifndef HELP_HANDLER_MINIMAL
             std::cerr << "Argument count (argc) is extremely large (256+)";
+            #else
+            const fragment warning = { "Argument count (argc) is extremely large (256+)", 47 };
+            writeFragments(2, &warning, 1);
+            #endif
         } else if (argc < 1) {
             if (argc < std::numeric_limits<int>::min()) {
                 throw std::invalid_argument("Argument count (argc) is smaller than the limit of int type");
@@ -100,52 +2232,67 @@ namespace helpHandler {
         /*******/
         /* Run */
         /*******/
-        unsigned matches = 0;
-        bool matchedHelp = false;
-        bool matchedVer  = false;
+        struct argScan scan;
+        HELP_HANDLER_PROBE1(match_start, argc);
+        HELP_HANDLER_STAT_START(start);
 
-        //Match arguments
-        std::vector<std::string> arguments(argv+1, argv+argc); //Start from argv+1 to skip binary name
-        for (auto arg: arguments) {
-                std::string r = "-{0,}h{1,}e{1,}l{1,}p{1,}(.*)";
-                if (options_t.extraStrings == true) { r += "|-{0,}h{1,}$"; }
-                if (std::regex_match(arg, std::regex(r)) == true) {
-                    matchedHelp = true;
-                    matches++; }
+        //Match arguments in place; nothing is copied out of argv, so cost stays flat however large argc gets
+        int i = 1; //Start from 1 to skip binary name
+        for (; i < argc && scan.done() == false; i++) {
+            const char* arg = argv[i];
+            if (!arg) {
+                throw std::invalid_argument("Argument count (argc) exceeds actual number of arguments"); }
+            if (std::strcmp(arg, "--") == 0) { //End of options, everything after is an operand
+                scan.ended = true;
+                break; }
+            #ifndef HELP_HANDLER_MINIMAL
+            if (arg[0] == '@' && (options.argSources & responseFiles) != 0 && options.readArgs(arg + 1, options, scan)) {
+                continue; }
+            #endif
 
-                r = "-{0,}v{1,}e{1,}r{1,}s{1,}i{1,}o{1,}n{1,}(.*)";
-                if (options_t.extraStrings == true) { r += "|^-{0,}v$"; }
-                if (std::regex_match(arg, std::regex(r)) == true) {
-                    matchedVer = true;
-                    matches++; }
+            scan.add(arg, matchOptions(arg, options));
         }
+        #ifndef HELP_HANDLER_MINIMAL
+        if (argsOnStdin && scan.done() == false) {
+            options.readArgs(nullptr, options, scan); }
+        #endif
+        HELP_HANDLER_STAT_TIME(matchNs, start);
+        HELP_HANDLER_STAT_ADD(argsScanned, (unsigned long long)(i - 1) + scan.streamed);
+        HELP_HANDLER_PROBE2(match_done, scan.matches, (unsigned long long)(i - 1) + scan.streamed);
 
         //Output appropriate results
-        if (matches > 0) {
-            if (matchedVer == true) {
-                switch (info_t.versionMostRecent) {
-                    case version_str: std::cout << trim(info_t.versionStr); break;
-                    case version_int: std::cout << info_t.versionInt; break; 
-                    case version_double: std::cout << info_t.versionDouble; break;
-                }
-
+        if (scan.matches > 0) {
+            if (scan.matchedVer == true && scan.matchedHelp == false) {
+                fragment version = versionOnly(rendered);
+                out.write(&version, 1);
+            } else {
+                selectTopic(help, scan.topic);
+                help.write(out, scan.matchedVer ? helpVersionHead(rendered) : helpHead(rendered), { "\n", 1 });
             }
 
-            if (matchedHelp == true) {
-                if (info_t.name.empty() == false) { std::cout << trim(info_t.name) << " "; }
-                    std::cout << help;
-                }
-
-            std::cout << std::endl;
-            return matches;
+            return (int)scan.matches;
         }
 
+        //No arguments in argv or on stdin
+        const unsigned long long given = (unsigned long long)(argc - 1) + scan.streamed;
+        if (given == 0 && options.noArgHelp == true) {
+            help.write(out, { "", 0 }, { "\n", 1 });
+            return EXIT_SUCCESS; }
+
         //End
-        if (options_t.unknownArgHelp == true && argc > 1) {
-            if (argc > 2) {
-                std::cout << "Unknown arguments given" << std::endl; 
+        if (options.unknownArgHelp == true && given > 0) {
+            #ifndef HELP_HANDLER_MINIMAL
+            if (options.suggestions != nullptr) {
+                reportUnknown(argc, argv, *options.suggestions, out);
+                return 0; }
+            #endif
+
+            if (given > 1) {
+                fragment unknown = { "Unknown arguments given\n", 24 };
+                out.write(&unknown, 1);
             } else {
-                std::cout << "Unknown argument given" << std::endl; }
+                fragment unknown = { "Unknown argument given\n", 23 };
+                out.write(&unknown, 1); }
 
             return 0;
         }
@@ -153,85 +2300,573 @@ namespace helpHandler {
         return 0;
     }
 
-    int handleFile(int argc, char** argv, const std::string& fileName) {
-        std::ifstream f;
-        std::string s;
+    //Matches what follows the subcommand path as if the last word of it were the program name, so "tool remote"
+    //with nothing after it is noArgHelp for remote, and "tool remote --help build" still prints remote's help
+    inline int dispatchCommand(int argc, char** argv, const commandTree& commands, const struct options_t& options,
+                               const struct render_t& rendered, const sink& out) {
+        fragment help, version;
+        const int depth = commands.resolve(argc, argv, help, version);
+        textHelp source = { help.size > 0 ? help : fragment{ "No usage help is available", 26 } };
+        //noArgHelp is for the program run bare. "tool remote" names a command, which is the program's to run
+        struct options_t commandOptions = options;
+        commandOptions.noArgHelp = options.noArgHelp && depth == 0;
+        if (version.size == 0) {
+            return dispatch(argc - depth, argv + depth, source, commandOptions, rendered, out); }
+
+        //The command's own version, under the program's name
+        const fragment head = helpHead(rendered);
+        const std::string name(head.data, head.size > 0 ? head.size - 1 : 0), ver(version.data, version.size);
+        std::string text(renderSize(name, ver), '\0');
+        struct render_t own;
+        render(name, ver, &text[0], own);
+        return dispatch(argc - depth, argv + depth, source, commandOptions, own, out);
+    }
+
+
+    /*
+     * Request mode
+     *
+     * The same matching as dispatch(), for callers that route many requests per second rather than handle one argv:
+     * tokens are views (no program name first, no NUL terminator needed), nothing is printed or allocated, nothing
+     * throws, and the response comes back as views into the rendered responses and the caller's help text
+     */
+    struct requestResult {
+        enum dialogType { none = 0, help, version, helpVersion, unknown };
+
+        dialogType dialog  = none;
+        long helpIndex     = -1; //Index of the first token that matched, -1 if none did
+        long versionIndex  = -1;
+        fragment response[3];    //Valid for as long as the handler state and help text are
+        size_t responseSize = 0; //Number of fragments used in response
+    };
+
+    inline int request(const fragment* tokens, size_t count, const fragment& help, const struct options_t& options,
+                       const struct render_t& rendered, requestResult& result) noexcept {
+        HELP_HANDLER_STAT_ADD(calls, 1);
+        result = requestResult();
+        if (tokens == nullptr && count > 0) {
+            return -1; }
+
+        const fragment helpText = help.size > 0 ? help : fragment{ "No usage help is available", 26 };
+        const fragment newline  = { "\n", 1 };
+        int matches = 0;
+
+        if (count == 0) {
+            if (options.noArgHelp == true) {
+                result.dialog = requestResult::help;
+                result.response[0] = helpText;
+                result.response[1] = newline;
+                result.responseSize = 2; }
+            return 0;
+        }
+
+        HELP_HANDLER_PROBE1(match_start, count);
+        HELP_HANDLER_STAT_START(start);
+        size_t i = 0;
+        for (; i < count && (result.helpIndex < 0 || result.versionIndex < 0); i++) {
+            if (tokens[i].data == nullptr) {
+                return -1; }
+            if (tokens[i].size == 2 && tokens[i].data[0] == '-' && tokens[i].data[1] == '-') { //End of options
+                break; }
+
+            switch (matchOptions(tokens[i].data, tokens[i].size, options)) {
+                case matchHelp:    if (result.helpIndex < 0)    { result.helpIndex = (long)i; }    matches++; break;
+                case matchVersion: if (result.versionIndex < 0) { result.versionIndex = (long)i; } matches++; break;
+                case matchNone:    break;
+            }
+        }
+        HELP_HANDLER_STAT_TIME(matchNs, start);
+        HELP_HANDLER_STAT_ADD(argsScanned, i);
+        HELP_HANDLER_PROBE2(match_done, matches, i);
+
+        if (result.helpIndex >= 0) {
+            result.dialog = result.versionIndex >= 0 ? requestResult::helpVersion : requestResult::help;
+            result.response[0] = result.versionIndex >= 0 ? helpVersionHead(rendered) : helpHead(rendered);
+            result.response[1] = helpText;
+            result.response[2] = newline;
+            result.responseSize = 3;
+        } else if (result.versionIndex >= 0) {
+            result.dialog = requestResult::version;
+            result.response[0] = versionOnly(rendered);
+            result.responseSize = 1;
+        } else if (options.unknownArgHelp == true) {
+            result.dialog = requestResult::unknown;
+            result.response[0] = count > 1 ? fragment{ "Unknown arguments given\n", 24 } : fragment{ "Unknown argument given\n", 23 };
+            result.responseSize = 1;
+        }
+
+        return matches;
+    }
+
+
+    /*
+     * Early exit
+     *
+     * Answers --help/--version from HELP_HANDLER_EARLY_EXIT's initialiser, before the program's own static
+     * initialisation or main() has run. Nothing with a dynamic initialiser can be used that early (std::cout
+     * included), so the text comes from the macro's literals and goes straight to fd 1, and the options from the
+     * macro's arguments: whatever main() later passes to config() hasn't happened yet. The matcher's tables are
+     * constexpr, so they're safe to use as is. Anything that isn't a help/version request falls through to the program
+     * untouched
+     */
+    inline void earlyExit(int argc, char** argv, const char* name, const char* version, const char* help,
+                          const struct options_t& options) noexcept {
+        if (argc < 1 || argv == nullptr) {
+            return; }
+
+        bool matchedHelp = false;
+        bool matchedVer  = false;
+        if (argc == 1) {
+            if (options.noArgHelp == false) {
+                return; }
+
+            fragment out[] = { { help, std::strlen(help) }, { "\n", 1 } };
+            writeFragments(1, out, 2);
+            std::_Exit(EXIT_SUCCESS);
+        }
+
+        for (int i = 1; i < argc && argv[i] != nullptr && !(matchedHelp && matchedVer); i++) {
+            if (std::strcmp(argv[i], "--") == 0) {
+                break; }
+
+            switch (matchArg(argv[i], options.extraStrings)) {
+                case matchHelp:    matchedHelp = true; break;
+                case matchVersion: matchedVer = true;  break;
+                case matchNone:    break;
+            }
+        }
+        if (matchedHelp == false && matchedVer == false) {
+            return; }
+
+        //Same layout handle() prints
+        fragment out[5];
+        size_t n = 0;
+        if (matchedVer == true) {
+            out[n++] = { version, std::strlen(version) }; }
+        if (matchedHelp == true) {
+            if (name[0] != '\0') {
+                out[n++] = { name, std::strlen(name) };
+                out[n++] = { " ", 1 }; }
+            out[n++] = { help, std::strlen(help) }; }
+        out[n++] = { "\n", 1 };
+
+        writeFragments(1, out, n);
+        std::_Exit(EXIT_SUCCESS); //Skip atexit handlers and destructors, nothing they'd clean up exists yet
+    }
+
+    //The same three settings config() takes, with the same defaults
+    inline void earlyExit(int argc, char** argv, const char* name, const char* version, const char* help,
+                          bool extraStrings = true, bool noArgHelp = true, bool unknownArgHelp = false) noexcept {
+        struct options_t options;
+        options.extraStrings   = extraStrings;
+        options.noArgHelp      = noArgHelp;
+        options.unknownArgHelp = unknownArgHelp; //Unknown arguments are left to handle() either way
+        earlyExit(argc, argv, name, version, help, options);
+    }
+
+    #ifdef __linux__
+    //For libcs that don't pass arguments to initialisers, read them back from the kernel instead
+    inline void earlyExitCmdline(const char* name, const char* version, const char* help,
+                                 bool extraStrings = true, bool noArgHelp = true, bool unknownArgHelp = false) noexcept {
+        static char cmdline[1 << 16];
+        static char* args[4096];
+
+        int fd = ::open("/proc/self/cmdline", O_RDONLY);
+        if (fd < 0) {
+            return; }
+
+        size_t size = 0;
+        ssize_t got;
+        while (size < sizeof(cmdline) && (got = ::read(fd, cmdline + size, sizeof(cmdline) - size)) != 0) {
+            if (got < 0) {
+                if (errno == EINTR) { continue; }
+                break; }
+            size += (size_t)got; }
+        ::close(fd);
+
+        //An argument cut off by the end of the buffer is dropped, handle() in main() still sees the full argv
+        int argc = 0;
+        for (size_t start = 0, i = 0; i < size && argc < 4096; i++) {
+            if (cmdline[i] == '\0') {
+                args[argc++] = cmdline + start;
+                start = i + 1; }
+        }
+
+        earlyExit(argc, args, name, version, help, extraStrings, noArgHelp, unknownArgHelp);
+    }
+    #endif
+
+
+    /****************/
+    /**** PUBLIC ****/
+    /****************/
+    inline int handle(int argc, char** argv, std::string help) {
+        if (help.empty()) {
+            help = "No usage help is available"; }
 
-        f.open(fileName, std::ios::in);
-        if (!f.is_open()) {
-            throw std::ios_base::failure("Could not open file"); }
-        if (f.peek() == std::ifstream::traits_type::eof()) {
-            throw std::runtime_error("Given help file is empty"); }
+        stringHelp source = { help };
+        return dispatch(argc, argv, source, global().options, global().rendered, global().output);
+    }
 
-        std::string line;
-        while(getline(f, line)) {
-            s += line; }
+    //The provider is only called if the help dialogue is actually going to be printed, and streams its chunks straight to the output
+    inline int handle(int argc, char** argv, const helpProvider& provider) {
+        providerHelp source = { provider };
+        return dispatch(argc, argv, source, global().options, global().rendered, global().output);
+    }
 
-         f.close();
+    //Prints only the help (and version, if it has one) of the subcommand argv names, see commandTree
+    inline int handle(int argc, char** argv, const commandTree& commands) {
+        return dispatchCommand(argc, argv, commands, global().options, global().rendered, global().output);
+    }
 
-        return helpHandler::handle(argc, argv, s);
+    //The file is only opened if the help dialogue is actually going to be printed
+    inline int handleFile(int argc, char** argv, const std::string& fileName) {
+        fileHelp source(fileName);
+        return dispatch(argc, argv, source, global().options, global().rendered, global().output);
     } 
 
-    void version(double version) noexcept {
-        info_t.versionDouble = version;
-        info_t.versionMostRecent = version_double;
-    } void version(unsigned int version) noexcept {
-        info_t.versionInt = version;
-        info_t.versionMostRecent = version_int;
-    } void version(std::string version) { //Parent
+    //Prints the help text of the locale LC_ALL, LC_MESSAGES or LANG names (or the bundle's default) from a bundle
+    //built with bundleWriter or tools/helpbundle.cpp, decompressing only what's printed. Topics work as for handleFile()
+    inline int handleBundle(int argc, char** argv, const std::string& fileName) {
+        bundleHelp source(fileName);
+        return dispatch(argc, argv, source, global().options, global().rendered, global().output);
+    }
+
+    //Numbers render into fixed storage, so these can't throw. Only with a name of over ~100 bytes does the rendering
+    //need the heap, and if that allocation fails the previous version stays
+    inline void version(double version) noexcept {
+        char number[32];
+        const fragment ver = versionNumber(version, number);
+        renderGlobal(nullptr, &ver);
+    } inline void version(unsigned int version) noexcept {
+        char number[32];
+        const fragment ver = versionNumber(version, number);
+        renderGlobal(nullptr, &ver);
+    } inline void version(std::string version) { //Parent
         if (version.empty()) {
             throw std::invalid_argument("Version string was given, but is empty"); }
         
-        info_t.versionStr = trim(version);
-        info_t.versionMostRecent = version_str;
+        const std::string ver = trim(version);
+        renderGlobal(nullptr, &ver);
     }
 
-    int handle(int argc, char** argv, std::string helpDialogue, std::string version) {
+    inline int handle(int argc, char** argv, std::string helpDialogue, std::string version) {
         helpHandler::version(version);
         return helpHandler::handle(argc, argv, helpDialogue);
-    } int handle(int argc, char** argv, std::string helpDialogue, double version) {
+    } inline int handle(int argc, char** argv, std::string helpDialogue, double version) {
         helpHandler::version(version);
         return helpHandler::handle(argc, argv, helpDialogue);
-    } int handle(int argc, char** argv, std::string helpDialogue, unsigned int version) {
+    } inline int handle(int argc, char** argv, std::string helpDialogue, unsigned int version) {
         helpHandler::version(version);
         return helpHandler::handle(argc, argv, helpDialogue);
     }
 
-    int handleFile(int argc, char** argv, const std::string& fileName, std::string version) {
+    inline int handleFile(int argc, char** argv, const std::string& fileName, std::string version) {
         helpHandler::version(version);
         return helpHandler::handleFile(argc, argv, fileName);
-    } int handleFile(int argc, char** argv, const std::string& fileName, double version) {
+    } inline int handleFile(int argc, char** argv, const std::string& fileName, double version) {
         helpHandler::version(version);
         return helpHandler::handleFile(argc, argv, fileName);
-    } int handleFile(int argc, char** argv, const std::string& fileName, unsigned int version) {
+    } inline int handleFile(int argc, char** argv, const std::string& fileName, unsigned int version) {
         helpHandler::version(version);
         return helpHandler::handleFile(argc, argv, fileName);
     }
 
 
-    void name(const std::string& appName) { //Parent
+    inline void name(const std::string& appName) { //Parent
         if (appName.empty()) {
             throw std::invalid_argument("App name was given, but is empty"); }
 
-        info_t.name = trim(appName);
+        const std::string name = trim(appName);
+        renderGlobal(&name, nullptr);
     }
 
-    void info(const std::string& appName, std::string version) {
+    inline void info(const std::string& appName, std::string version) {
         helpHandler::name(appName);
         helpHandler::version(version);
-    } void info(const std::string& appName, double version) {
+    } inline void info(const std::string& appName, double version) {
         helpHandler::name(appName);
         helpHandler::version(version);
-    } void info(const std::string& appName, unsigned int version) {
+    } inline void info(const std::string& appName, unsigned int version) {
         helpHandler::name(appName);
         helpHandler::version(version);
     }
 
-    void config(bool extraStrings=true, bool noArgHelp=true, bool unknownArgHelp=false) noexcept {
-        if (options_t.extraStrings != extraStrings) options_t.extraStrings = extraStrings;
-        if (options_t.noArgHelp != noArgHelp) options_t.noArgHelp = noArgHelp;
-        if (options_t.unknownArgHelp != unknownArgHelp)  options_t.unknownArgHelp = unknownArgHelp;
+    //Returns the number of tokens matched, or -1 if tokens is NULL or holds a NULL token
+    inline int request(const fragment* tokens, size_t count, const fragment& help, requestResult& result) noexcept {
+        return request(tokens, count, help, global().options, global().rendered, result);
+    }
+
+    inline void output(const sink& destination) noexcept {
+        global().output = destination;
+    }
+
+    //The help text given to HELP_HANDLER_NOTE, for handle(), or nullptr without one
+    inline const char* notedHelp() noexcept {
+        return global().notedHelp;
+    }
+
+    inline void config(bool extraStrings=true, bool noArgHelp=true, bool unknownArgHelp=false) noexcept {
+        struct options_t& options = global().options;
+        if (options.extraStrings != extraStrings) options.extraStrings = extraStrings;
+        if (options.noArgHelp != noArgHelp) options.noArgHelp = noArgHelp;
+        if (options.unknownArgHelp != unknownArgHelp)  options.unknownArgHelp = unknownArgHelp;
         return;
     }
+
+    #ifndef HELP_HANDLER_MINIMAL
+    //With unknownArgHelp on, name unknown arguments and suggest the closest registered ones. index must outlive its
+    //use here, and nullptr goes back to the plain "Unknown argument(s) given"
+    inline void suggest(const suggestionIndex* index) noexcept {
+        global().options.suggestions = index;
+    }
+    #endif
+
+    #ifndef HELP_HANDLER_MINIMAL
+    //Also match arguments up to maxDistance typos from help/version (at most 3). 0, the default, turns it off
+    inline void typos(unsigned maxDistance) noexcept {
+        global().options.typoDistance = maxDistance < maxTypoDistance ? maxDistance : maxTypoDistance;
+    }
+    #endif
+
+    #ifndef HELP_HANDLER_MINIMAL
+    //Where arguments are read from besides argv: argSource bits, such as responseFiles | stdinLines. argvOnly, the
+    //default, turns it off
+    inline void sources(unsigned which) noexcept {
+        global().options.argSources = which;
+        global().options.readArgs = readArgs;
+    }
+    #endif
+
+    #ifdef HELP_HANDLER_STATS
+    //Totals since start up or the last resetStatistics(), across the free functions and every HelpHandler
+    struct stats {
+        unsigned long long calls;        //handle(), handleFile() and request() calls
+        unsigned long long argsScanned;  //Arguments matched against before each call stopped
+        unsigned long long matchNs;      //Time spent matching them
+        unsigned long long fileLoads;    //Help files opened by handleFile()
+        unsigned long long fileBytes;
+        unsigned long long fileNs;       //Opening and mapping (or reading) them
+        unsigned long long writes;       //Sink writes, each a single writev() or flush
+        unsigned long long bytesWritten;
+        unsigned long long writeNs;
+    };
+
+    inline stats statistics() noexcept {
+        stats out;
+        out.calls        = counters().calls.load(std::memory_order_relaxed);
+        out.argsScanned  = counters().argsScanned.load(std::memory_order_relaxed);
+        out.matchNs      = counters().matchNs.load(std::memory_order_relaxed);
+        out.fileLoads    = counters().fileLoads.load(std::memory_order_relaxed);
+        out.fileBytes    = counters().fileBytes.load(std::memory_order_relaxed);
+        out.fileNs       = counters().fileNs.load(std::memory_order_relaxed);
+        out.writes       = counters().writes.load(std::memory_order_relaxed);
+        out.bytesWritten = counters().bytesWritten.load(std::memory_order_relaxed);
+        out.writeNs      = counters().writeNs.load(std::memory_order_relaxed);
+        return out;
+    }
+
+    inline void resetStatistics() noexcept {
+        struct stats_t& totals = counters();
+        for (std::atomic<unsigned long long>* counter: { &totals.calls, &totals.argsScanned, &totals.matchNs, &totals.fileLoads,
+                                                         &totals.fileBytes, &totals.fileNs, &totals.writes, &totals.bytesWritten, &totals.writeNs }) {
+            counter->store(0, std::memory_order_relaxed); }
+    }
+    #endif
+
+
+    /*
+     * Instance API
+     *
+     * Holds an immutable snapshot of name/version/options, and the responses rendered from them, behind a
+     * shared_ptr. The with*() functions return a new handler and leave the original untouched, so one handler
+     * can be shared by any number of threads and handle() never takes a lock; copying one only bumps a refcount.
+     * The free functions above keep using the global state
+     */
+    class HelpHandler {
+    public:
+        HelpHandler() : state(std::make_shared<const snapshot>()) {}
+
+        HelpHandler withName(const std::string& appName) const {
+            if (appName.empty()) {
+                throw std::invalid_argument("App name was given, but is empty"); }
+
+            return modified([&](struct info_t& info, struct options_t&) { info.name = trim(appName); });
+        }
+
+        HelpHandler withVersion(const std::string& version) const {
+            if (version.empty()) {
+                throw std::invalid_argument("Version string was given, but is empty"); }
+
+            return modified([&](struct info_t& info, struct options_t&) {
+                info.versionStr = trim(version);
+                info.versionMostRecent = version_str; });
+        } HelpHandler withVersion(double version) const {
+            return modified([&](struct info_t& info, struct options_t&) {
+                info.versionDouble = version;
+                info.versionMostRecent = version_double; });
+        } HelpHandler withVersion(unsigned int version) const {
+            return modified([&](struct info_t& info, struct options_t&) {
+                info.versionInt = version;
+                info.versionMostRecent = version_int; });
+        }
+
+        HelpHandler withConfig(bool extraStrings=true, bool noArgHelp=true, bool unknownArgHelp=false) const {
+            return modified([&](struct info_t&, struct options_t& options) {
+                options.extraStrings   = extraStrings;
+                options.noArgHelp      = noArgHelp;
+                options.unknownArgHelp = unknownArgHelp; });
+        }
+
+        #ifndef HELP_HANDLER_MINIMAL
+        HelpHandler withTypos(unsigned maxDistance) const {
+            return modified([&](struct info_t&, struct options_t& options) {
+                options.typoDistance = maxDistance < maxTypoDistance ? maxDistance : maxTypoDistance; });
+        }
+        #endif
+
+        #ifndef HELP_HANDLER_MINIMAL
+        HelpHandler withSources(unsigned which) const {
+            return modified([&](struct info_t&, struct options_t& options) {
+                options.argSources = which;
+                options.readArgs = readArgs; });
+        }
+        #endif
+
+        #ifndef HELP_HANDLER_MINIMAL
+        HelpHandler withSuggestions(std::shared_ptr<const suggestionIndex> index) const {
+            std::shared_ptr<snapshot> next = std::make_shared<snapshot>(*state);
+            next->suggestions = std::move(index);
+            next->options.suggestions = next->suggestions.get();
+            next->render();
+            return HelpHandler(std::move(next));
+        }
+        #endif
+
+        //Output goes to out rather than the global output(), so each caller can have its own
+        int handle(int argc, char** argv, const std::string& help, const sink& out = sink()) const {
+            static const std::string noHelp = "No usage help is available";
+            stringHelp source = { help.empty() ? noHelp : help };
+            return dispatch(argc, argv, source, state->options, state->rendered, out);
+        } int handle(int argc, char** argv, const helpProvider& provider, const sink& out = sink()) const {
+            providerHelp source = { provider };
+            return dispatch(argc, argv, source, state->options, state->rendered, out);
+        } int handle(int argc, char** argv, const commandTree& commands, const sink& out = sink()) const {
+            return dispatchCommand(argc, argv, commands, state->options, state->rendered, out);
+        }
+
+        int handleFile(int argc, char** argv, const std::string& fileName, const sink& out = sink()) const {
+            fileHelp source(fileName);
+            return dispatch(argc, argv, source, state->options, state->rendered, out);
+        }
+
+        int handleBundle(int argc, char** argv, const std::string& fileName, const sink& out = sink()) const {
+            bundleHelp source(fileName);
+            return dispatch(argc, argv, source, state->options, state->rendered, out);
+        }
+
+        //result's response views stay valid for as long as this handler (or a copy of it) and help do
+        int request(const fragment* tokens, size_t count, const fragment& help, requestResult& result) const noexcept {
+            return helpHandler::request(tokens, count, help, state->options, state->rendered, result);
+        }
+
+    private:
+        struct snapshot {
+            struct info_t info;
+            struct options_t options;
+            std::string text;        //What rendered points into, so a copy has to render() again
+            struct render_t rendered;
+            #ifndef HELP_HANDLER_MINIMAL
+            std::shared_ptr<const suggestionIndex> suggestions; //Keeps options.suggestions alive
+            #endif
+
+            void render() {
+                const std::string ver = versionText(info);
+                text.resize(renderSize(info.name, ver));
+                helpHandler::render(info.name, ver, &text[0], rendered);
+            }
+        };
+
+        std::shared_ptr<const snapshot> state;
+
+        explicit HelpHandler(std::shared_ptr<const snapshot> state) : state(std::move(state)) {}
+
+        template<typename Edit>
+        HelpHandler modified(Edit edit) const {
+            std::shared_ptr<snapshot> next = std::make_shared<snapshot>(*state);
+            edit(next->info, next->options);
+            next->render();
+            return HelpHandler(std::move(next));
+        }
+    };
 }
+
+
+/*
+ * HELP_HANDLER_EARLY_EXIT("name", "version", "help dialogue");
+ * HELP_HANDLER_EARLY_EXIT("name", "version", "help dialogue", extraStrings, noArgHelp, unknownArgHelp);
+ *
+ * Opt-in, use it once at namespace scope in the executable (not a shared library). --help/--version are then
+ * answered before the program's static initialisers and main() run, and the process exits straight away. The early
+ * pass runs before main() can call config(), so a program that changes those settings passes the same values here,
+ * after the help dialogue; left out, they're config()'s defaults. Keep calling handle() in main() as usual, it covers
+ * platforms without early initialisers and anything the early pass didn't answer
+ */
+#if defined(__GLIBC__) && defined(__ELF__)
+    //glibc passes argc/argv/envp to .preinit_array entries, which run before every other initialiser in the process
+    #define HELP_HANDLER_EARLY_EXIT(appName, appVersion, ...) \
+        static void helpHandlerEarlyExit(int argc, char** argv, char**) { helpHandler::earlyExit(argc, argv, appName, appVersion, __VA_ARGS__); } \
+        __attribute__((section(".preinit_array"), used)) static void (*helpHandlerEarlyExitEntry)(int, char**, char**) = helpHandlerEarlyExit
+#elif defined(__APPLE__) && defined(__GNUC__)
+    //dyld passes argc/argv/envp to constructors. 101 is the earliest priority not reserved for the implementation
+    #define HELP_HANDLER_EARLY_EXIT(appName, appVersion, ...) \
+        __attribute__((constructor(101))) static void helpHandlerEarlyExit(int argc, char** argv, char**) { helpHandler::earlyExit(argc, argv, appName, appVersion, __VA_ARGS__); } \
+        static_assert(true, "")
+#elif defined(__linux__) && defined(__GNUC__)
+    //musl and others don't pass arguments to initialisers, so they're read back from /proc/self/cmdline
+    #define HELP_HANDLER_EARLY_EXIT(appName, appVersion, ...) \
+        __attribute__((constructor(101))) static void helpHandlerEarlyExit() { helpHandler::earlyExitCmdline(appName, appVersion, __VA_ARGS__); } \
+        static_assert(true, "")
+#else
+    //No early initialiser available, handle() in main() answers as usual
+    #define HELP_HANDLER_EARLY_EXIT(appName, appVersion, ...) static_assert(true, "")
+#endif
+
+
+/*
+ * HELP_HANDLER_NOTE("name", "version", "help dialogue");
+ *
+ * Embeds the name, version and help text in an ELF note (.note.helphandler, owner "HelpHandler", type 1) at
+ * compile time, so cpp/tools/helpscan can read them without executing the binary, and registers the same bytes as the
+ * name and version before any dynamic initialiser runs. Use it once at namespace scope in place of info(), and pass
+ * notedHelp() to handle(), so there's only one copy for the scanner and --version/--help to disagree about. The
+ * arguments must be string literals. Elsewhere than ELF there is no note, but the name and version are still registered
+ */
+#if defined(__ELF__) && defined(__GNUC__)
+    #define HELP_HANDLER_NOTE_SECTION __attribute__((section(".note.helphandler"), used, aligned(4)))
+#else
+    #define HELP_HANDLER_NOTE_SECTION
+#endif
+#ifdef __GNUC__
+    #define HELP_HANDLER_NOTE_REGISTER \
+        __attribute__((constructor(102))) static void helpHandlerNoteInfo() { helpHandler::noteInfo(helpHandlerNote.desc); }
+#else
+    #define HELP_HANDLER_NOTE_REGISTER \
+        static const bool helpHandlerNoteInfo = helpHandler::noteInfo(helpHandlerNote.desc);
+#endif
+#define HELP_HANDLER_NOTE(appName, appVersion, helpDialogue) \
+    HELP_HANDLER_NOTE_SECTION static const struct { \
+        unsigned int nameSize, descSize, type; \
+        char name[12]; \
+        char desc[(sizeof(appName) + sizeof(appVersion) + sizeof(helpDialogue) + 3) & ~3u]; \
+    } helpHandlerNote = { 12, sizeof(appName) + sizeof(appVersion) + sizeof(helpDialogue), 1, "HelpHandler", appName "\0" appVersion "\0" helpDialogue }; \
+    HELP_HANDLER_NOTE_REGISTER \
+    static_assert(true, "")
+
+#undef HELP_HANDLER_STAT_ADD
+#undef HELP_HANDLER_STAT_START
+#undef HELP_HANDLER_STAT_TIME
+#undef HELP_HANDLER_PROBE
+#undef HELP_HANDLER_PROBE1
+#undef HELP_HANDLER_PROBE2
 #endif  /* HELP_HANDLER_HPP */
@@ -0,0 +1,208 @@
+/*
+ * Help bundles: every lzCompress() output decodes back to its input, every truncated or byte-flipped block is either
+ * rejected or decodes to exactly the size asked for (never past it, build with -fsanitize=address to check), truncated
+ * and corrupt bundles throw std::runtime_error, and locales fall back from language_territory to the language to the
+ * bundle's default, as findLocale() and handleBundle() with LC_ALL/LANG both see it. Exits 1 on any failure
+ *
+ * g++ -std=c++11 -O2 bundle.cpp -o bundle && ./bundle
+ */
+#include "../helpHandler.hpp"
+
+
+
+
+static int failures = 0;
+static void check(bool passed, const std::string& what) {
+    if (passed == false) {
+        failures++;
+        std::printf("failed: %s\n", what.c_str()); }
+}
+
+static unsigned seed = 12345;
+static unsigned next() {
+    seed = seed * 1103515245 + 12345;
+    return seed >> 8;
+}
+
+//Short, long, repetitive (overlapping matches), literal runs over 15 and 270 bytes, and incompressible bytes
+static std::vector<std::string> inputs() {
+    std::vector<std::string> out = { "", "a", "usage: app", "abcdefghijkl", "abcdefghijklm", std::string(13, 'x'),
+                                     std::string(300, 'a'), std::string(70000, '-') };
+    std::string words, noise, help;
+    for (int i = 0; i < 2000; i++) {
+        words += i % 7 == 0 ? "--option " : i % 3 == 0 ? "value\n" : "text "; }
+    for (int i = 0; i < 5000; i++) {
+        noise += (char)(next() & 0xff); }
+    for (int t = 0; t < 50; t++) {
+        help += "[[topic" + std::to_string(t) + "]]\n  --flag-" + std::to_string(next() % 1000) + "   sets the thing\n"; }
+    out.push_back(words);
+    out.push_back(noise);
+    out.push_back(help);
+    out.push_back(noise + words + noise);
+    return out;
+}
+
+static bool decodes(const std::string& block, const std::string& expected) {
+    std::vector<char> out(expected.size() + 1);
+    return helpHandler::lzDecompress((const unsigned char*)block.data(), block.size(), out.data(), expected.size())
+           && std::memcmp(out.data(), expected.data(), expected.size()) == 0;
+}
+
+static void roundTrips() {
+    for (const std::string& input: inputs()) {
+        const std::string block = helpHandler::lzCompress(input.data(), input.size());
+        check(decodes(block, input), "round trip of " + std::to_string(input.size()) + " bytes");
+
+        //Too short or too long an output size is corrupt, not a partial decode
+        std::vector<char> out(input.size() + 2);
+        if (input.size() > 0) {
+            check(!helpHandler::lzDecompress((const unsigned char*)block.data(), block.size(), out.data(), input.size() - 1),
+                  "decoding " + std::to_string(input.size()) + " bytes into one too few"); }
+        check(!helpHandler::lzDecompress((const unsigned char*)block.data(), block.size(), out.data(), input.size() + 1),
+              "decoding " + std::to_string(input.size()) + " bytes into one too many");
+    }
+}
+
+static void damagedBlocks() {
+    for (const std::string& input: inputs()) {
+        const std::string block = helpHandler::lzCompress(input.data(), input.size());
+        std::vector<char> out(input.size() + 1);
+
+        //Every prefix ends inside a sequence or before the last one, so none can fill the output
+        const size_t step = block.size() > 4096 ? 7 : 1;
+        for (size_t cut = 0; cut < block.size(); cut += step) {
+            check(!helpHandler::lzDecompress((const unsigned char*)block.data(), cut, out.data(), input.size()) || input.empty(),
+                  "block of " + std::to_string(input.size()) + " bytes cut at " + std::to_string(cut)); }
+
+        //A flipped byte may still decode (a literal changed), but only ever to exactly the size asked for
+        for (int flip = 0; flip < 200 && !block.empty(); flip++) {
+            std::string corrupt = block;
+            corrupt[next() % corrupt.size()] ^= (char)(1 + next() % 255);
+            std::vector<char> bounded(input.size() + 1);
+            helpHandler::lzDecompress((const unsigned char*)corrupt.data(), corrupt.size(), bounded.data(), input.size());
+        }
+    }
+
+    //Hand-made sequences: an offset of 0, an offset before the start, a match past the end, a length run off the end
+    const struct { const char* block; size_t size; const char* what; } bad[] = {
+        { "\x14" "a" "\x00\x00", 4, "offset 0" },
+        { "\x14" "a" "\x02\x00", 4, "offset before the start" },
+        { "\x1f" "a" "\x01\x00" "\xff", 5, "match length running off the block" },
+        { "\xf0" "\xff", 2, "literal length running off the block" },
+        { "\x50" "abc", 4, "literals past the end of the block" },
+    };
+    char out[64];
+    for (const auto& b: bad) {
+        check(!helpHandler::lzDecompress((const unsigned char*)b.block, b.size, out, 8), b.what); }
+    check(!helpHandler::lzDecompress((const unsigned char*)"\x1f" "a" "\x01\x00" "\x00", 5, out, 8),
+          "match of 20 bytes into 8");
+}
+
+static std::string sampleBundle() {
+    helpHandler::bundleWriter writer;
+    writer.add("en", "usage: app\n[[files]]\nen files\n");
+    writer.add("de", "Aufruf: app\n[[files]]\nde Dateien\n");
+    writer.add("de_AT", "Aufruf: app (AT)\n");
+    writer.add("pt_BR", "uso: app\n");
+    return writer.serialize();
+}
+
+static void damagedBundles() {
+    const std::string bundle = sampleBundle();
+    for (size_t cut = 0; cut < bundle.size(); cut++) {
+        const size_t tables = helpHandler::bundleView::tablesSize(bundle.data(), bundle.size());
+        bool threw = false;
+        try {
+            helpHandler::bundleView(bundle.data(), cut);
+        } catch (const std::runtime_error&) {
+            threw = true; }
+        check(threw || cut >= tables, "bundle cut at " + std::to_string(cut) + " of " + std::to_string(tables) + " table bytes"); }
+
+    //Any byte of the tables flipped either throws or leaves every offset inside the bundle, and every block decodes
+    //(or fails to) without reading or writing outside it
+    for (size_t at = 0; at < helpHandler::bundleView::tablesSize(bundle.data(), bundle.size()); at++) {
+        std::string corrupt = bundle;
+        corrupt[at] ^= (char)0x5a;
+        try {
+            const helpHandler::bundleView view(corrupt.data(), corrupt.size());
+            for (uint32_t l = 0; l < view.localeCount(); l++) {
+                for (uint32_t e = view.firstEntry(l); e < view.firstEntry(l) + view.entryCount(l); e++) {
+                    std::vector<char> out(view.textSize(e) + 1);
+                    view.decompress(e, out.data()); }
+            }
+        } catch (const std::runtime_error&) {}
+    }
+}
+
+static std::string name(const helpHandler::bundleView& view, uint32_t l) {
+    return l == helpHandler::bundleView::none ? "none" : std::string(view.localeName(l).data, view.localeName(l).size);
+}
+
+static void localeFallback() {
+    const std::string bundle = sampleBundle();
+    const helpHandler::bundleView view(bundle.data(), bundle.size());
+    const struct { const char* locale; const char* expected; } cases[] = {
+        { "de_AT.UTF-8@euro", "de_AT" }, { "de_AT", "de_AT" }, { "de_CH.UTF-8", "de" }, { "de", "de" },
+        { "pt_PT.UTF-8", "pt_BR" }, { "pt", "pt_BR" }, { "fr_FR.UTF-8", "en" }, { "C", "en" }, { "POSIX", "en" },
+        { "d", "en" }, { "dea", "en" }, { nullptr, "en" },
+    };
+    for (const auto& c: cases) {
+        const std::string found = name(view, view.findLocale(c.locale));
+        check(found == c.expected, std::string("locale ") + (c.locale ? c.locale : "(none)") + " picked " + found
+                                   + ", expected " + c.expected); }
+
+    const char* fileName = "/tmp/help_handler_bundle_test.hhb";
+    FILE* fp = std::fopen(fileName, "wb");
+    std::fwrite(bundle.data(), 1, bundle.size(), fp);
+    std::fclose(fp);
+    const helpHandler::HelpHandler handler = helpHandler::HelpHandler().withName("app");
+    const struct { const char* lcAll; const char* lang; const char* topic; const char* expected; } runs[] = {
+        { "", "de_CH.UTF-8", nullptr, "Aufruf: app\n[[files]]\nde Dateien\n" },
+        { "", "de_CH.UTF-8", "files", "de Dateien\n" },
+        { "", "de_AT.UTF-8", "files", "Aufruf: app (AT)\n" }, //No such topic in de_AT, so all of it
+        { "fr_FR", "de_AT", "files", "en files\n" },         //LC_ALL wins over LANG
+        { "", "", nullptr, "usage: app\n[[files]]\nen files\n" },
+    };
+    for (const auto& r: runs) {
+        ::setenv("LC_ALL", r.lcAll, 1);
+        ::setenv("LANG", r.lang, 1);
+        char app[] = "app", help[] = "--help";
+        char* argv[] = { app, help, const_cast<char*>(r.topic), nullptr };
+        char out[256];
+        size_t length = 0;
+        const int matched = handler.handleBundle(r.topic ? 3 : 2, argv, fileName, helpHandler::sink(out, sizeof(out), &length));
+        const std::string printed(out, length < sizeof(out) ? length : sizeof(out));
+        check(matched == 1 && printed == std::string("app ") + r.expected,
+              std::string("LC_ALL=") + r.lcAll + " LANG=" + r.lang + " printed \"" + printed + "\""); }
+
+    //A corrupt block is an exception, not garbage on the terminal
+    std::string corrupt = bundle;
+    corrupt[(size_t)(view.block(view.firstEntry(view.findLocale("en"))).data - bundle.data())] = (char)0x0f; //A match first
+    fp = std::fopen(fileName, "wb");
+    std::fwrite(corrupt.data(), 1, corrupt.size(), fp);
+    std::fclose(fp);
+    ::setenv("LC_ALL", "en", 1);
+    char app[] = "app", help[] = "--help";
+    char* argv[] = { app, help, nullptr };
+    char out[256];
+    size_t length = 0;
+    bool threw = false;
+    try {
+        handler.handleBundle(2, argv, fileName, helpHandler::sink(out, sizeof(out), &length));
+    } catch (const std::runtime_error&) {
+        threw = true; }
+    check(threw && length == 0, "corrupt block printed \"" + std::string(out, length < sizeof(out) ? length : sizeof(out)) + "\"");
+    ::unlink(fileName);
+}
+
+
+
+
+int main() {
+    roundTrips();
+    damagedBlocks();
+    damagedBundles();
+    localeFallback();
+    std::printf("%d failures\n", failures);
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
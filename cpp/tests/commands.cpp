@@ -0,0 +1,59 @@
+/*
+ * What handle() prints and returns for a commandTree: the program run bare gets its no-argument help, a bare registered
+ * subcommand is left to the program (nothing printed, 0 returned), and help/version under a subcommand print that
+ * command's text. Exits 1 on any difference
+ *
+ * g++ -std=c++11 -O2 commands.cpp -o commands && ./commands
+ */
+#include "../helpHandler.hpp"
+
+
+
+
+struct testCase {
+    std::vector<const char*> args;
+    int matched;
+    const char* printed;
+};
+
+int main() {
+    helpHandler::commandTree commands;
+    commands.add("", "usage: tool <command>");
+    commands.add("remote", "usage: tool remote <add|remove>");
+    commands.add("remote add", "usage: tool remote add <name> <url>");
+    commands.add("plugin lint", "usage: tool plugin lint <files>", "0.3");
+    const helpHandler::HelpHandler handler = helpHandler::HelpHandler().withName("tool").withVersion("1.0");
+
+    const testCase cases[] = {
+        { { "tool" }, 0, "usage: tool <command>\n" },
+        { { "tool", "remote" }, 0, "" },
+        { { "tool", "remote", "add" }, 0, "" },
+        { { "tool", "remote", "add", "origin", "url" }, 0, "" },
+        { { "tool", "remote", "--help" }, 1, "tool usage: tool remote <add|remove>\n" },
+        { { "tool", "remote", "add", "-h" }, 1, "tool usage: tool remote add <name> <url>\n" },
+        { { "tool", "plugin", "lint", "--version" }, 1, "0.3\n" },
+        { { "tool", "remote", "--version" }, 1, "1.0\n" },
+        { { "tool", "--", "remote", "--help" }, 0, "" },
+    };
+
+    int failures = 0;
+    for (const testCase& c: cases) {
+        std::vector<char*> argv;
+        std::string joined;
+        for (const char* arg: c.args) {
+            argv.push_back(const_cast<char*>(arg));
+            joined += joined.empty() ? arg : std::string(" ") + arg; }
+        argv.push_back(nullptr);
+
+        char out[256];
+        size_t length = 0;
+        const int matched = handler.handle((int)c.args.size(), argv.data(), commands, helpHandler::sink(out, sizeof(out), &length));
+        const std::string printed(out, length < sizeof(out) ? length : sizeof(out));
+        if (matched != c.matched || printed != c.printed) {
+            failures++;
+            std::printf("\"%s\" returned %d and printed \"%s\", expected %d and \"%s\"\n", joined.c_str(), matched, printed.c_str(), c.matched, c.printed); }
+    }
+
+    std::printf("%zu cases, %d failures\n", sizeof(cases) / sizeof(cases[0]), failures);
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
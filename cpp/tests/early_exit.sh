@@ -0,0 +1,39 @@
+#!/bin/sh
+# Checks HELP_HANDLER_EARLY_EXIT answers with the settings given to it: a program built with the defaults prints its
+# version for -v and its help when run bare without reaching main(), and one built with extraStrings and noArgHelp off
+# (as a program whose -v means verbose would be) leaves both to main(), while --version is still answered early
+#
+# sh early_exit.sh (CXX overrides the compiler, g++ by default)
+CXX=${CXX:-g++}
+DIR=$(cd "$(dirname "$0")" && pwd)
+TMP=$(mktemp -d)
+trap 'rm -rf "$TMP"' EXIT
+
+program() { #program <name> <extra macro arguments>
+    printf '#include "%s/../helpHandler.hpp"\nHELP_HANDLER_EARLY_EXIT("app", "1.0", "usage: app"%s);\nint main() { std::printf("main\\n"); return 0; }\n' "$DIR" "$2" > "$TMP/$1.cpp"
+    $CXX -std=c++11 -O2 $CXXFLAGS "$TMP/$1.cpp" -o "$TMP/$1" || exit 1
+}
+program defaults ""
+program verbose ", false, false, false"
+
+status=0
+check() { #check <program> <expected output> <arguments...>
+    name=$1 expected=$2
+    shift 2
+    got=$("$TMP/$name" "$@")
+    if [ "$got" = "$expected" ]; then
+        printf '%-9s %-10s -> %s\n' "$name" "$*" "$got"
+    else
+        printf '%-9s %-10s -> "%s", expected "%s"\n' "$name" "$*" "$got" "$expected" >&2
+        status=1
+    fi
+}
+check defaults "1.0" -v
+check defaults "usage: app"
+check defaults "1.0" --version
+check defaults "main" run
+check verbose "main" -v
+check verbose "main"
+check verbose "1.0" --version
+check verbose "app usage: app" --help
+exit $status
@@ -0,0 +1,162 @@
+/*
+ * Differential test of the argument DFA against the std::regex patterns it replaced, with extraStrings on and off.
+ * The corpus is generated: the keywords with letters repeated, dropped, swapped and recased, dashes, tails with
+ * '\n'/'\r'/NUL/high bytes, and plain random bytes. Every token goes through matchArg() (NUL terminated and sized)
+ * and through matchFrom() split at a random point, and each has to agree with std::regex_match. Then a fixed list of
+ * typo matching cases, words and file names that must not count as help or version among them. Exits 1 on any mismatch
+ *
+ * g++ -std=c++11 -O2 matcher.cpp -o matcher && ./matcher [tokens=300000] [seed]
+ */
+#include "../helpHandler.hpp"
+
+
+#include <cstring>
+#include <regex>
+
+
+
+
+static unsigned seed = 12345;
+static unsigned next() {
+    seed = seed * 1103515245 + 12345;
+    return seed >> 8;
+}
+
+//The patterns handle() used before the DFA, as they were built there
+static std::regex pattern(bool help, bool extraStrings) {
+    std::string r = help ? "-{0,}h{1,}e{1,}l{1,}p{1,}(.*)" : "-{0,}v{1,}e{1,}r{1,}s{1,}i{1,}o{1,}n{1,}(.*)";
+    if (extraStrings == true) {
+        r += help ? "|-{0,}h{1,}$" : "|^-{0,}v$"; }
+    return std::regex(r);
+}
+
+//A keyword, each letter repeated 0 to 3 times, sometimes recased or swapped with its neighbour
+static std::string mutate(const char* keyword) {
+    std::string out;
+    for (const char* c = keyword; *c != '\0'; c++) {
+        unsigned repeat = next() % 10 == 0 ? 0 : next() % 8 == 0 ? 1 + next() % 3 : 1;
+        char letter = next() % 25 == 0 ? (char)std::toupper((unsigned char)*c) : *c;
+        out.append(repeat, letter);
+    }
+    if (out.size() > 1 && next() % 20 == 0) {
+        const size_t at = next() % (out.size() - 1);
+        std::swap(out[at], out[at + 1]); }
+    return out;
+}
+
+static std::string token() {
+    static const char tailBytes[] = { 'a', 'h', 'v', 'e', '-', '=', ':', ' ', '\n', '\r', '\0', '\t', (char)0xe9, (char)0xff };
+    std::string out;
+    const unsigned kind = next() % 10;
+    if (kind == 0) { //Random bytes, mostly from the letters the DFA cares about
+        static const char letters[] = "-helpvrsionHELPVx\n\r";
+        for (unsigned n = next() % 12; n > 0; n--) {
+            out += next() % 4 == 0 ? (char)(next() % 256) : letters[next() % (sizeof(letters) - 1)]; }
+        return out;
+    }
+
+    out.append(next() % 4 == 0 ? 0 : next() % 4, '-');
+    if (kind <= 2) { //Short forms, which only match with extraStrings
+        out.append(1 + next() % 3 * (next() % 2), next() % 2 == 0 ? 'h' : 'v');
+    } else {
+        out += mutate(kind <= 6 ? "help" : "version"); }
+    if (next() % 3 == 0) {
+        for (unsigned n = 1 + next() % 6; n > 0; n--) {
+            out += tailBytes[next() % sizeof(tailBytes)]; }
+    }
+    return out;
+}
+
+static const char* name(helpHandler::matchResult result) {
+    return result == helpHandler::matchHelp ? "help" : result == helpHandler::matchVersion ? "version" : "none";
+}
+
+//Typo matching only looks at options, and only as far as a third of the keyword. Returns the number of mismatches
+static unsigned long typoCases() {
+    #ifdef HELP_HANDLER_MINIMAL
+    return 0;
+    #else
+    using helpHandler::matchHelp;
+    using helpHandler::matchVersion;
+    const helpHandler::matchResult none = helpHandler::matchNone;
+    //Expected at typos 1, 2 and 3 (which is 2)
+    const struct { const char* arg; helpHandler::matchResult expected[3]; } cases[] = {
+        { "heap", { none, none, none } }, { "yelp", { none, none, none } }, { "kelp", { none, none, none } },
+        { "tell", { none, none, none } }, { "hello", { none, none, none } }, { "session", { none, none, none } },
+        { "person", { none, none, none } }, { "vision", { none, none, none } }, { "hepl.c", { none, none, none } },
+        { "-tell", { none, none, none } }, { "--hell0", { none, none, none } }, { "--passion", { none, none, none } },
+        { "--hlep", { matchHelp, matchHelp, matchHelp } }, { "-hepl", { matchHelp, matchHelp, matchHelp } },
+        { "-hlp", { matchHelp, matchHelp, matchHelp } }, { "--verison", { matchVersion, matchVersion, matchVersion } },
+        { "--vresoin", { none, matchVersion, matchVersion } }, { "--versoin", { matchVersion, matchVersion, matchVersion } },
+    };
+
+    unsigned long mismatches = 0;
+    for (unsigned distance = 1; distance <= 3; distance++) {
+        struct options_t options;
+        options.typoDistance = distance < helpHandler::maxTypoDistance ? distance : helpHandler::maxTypoDistance;
+        for (const auto& c: cases) {
+            const helpHandler::matchResult got = helpHandler::matchOptions(c.arg, options);
+            if (got != c.expected[distance - 1]) {
+                mismatches++;
+                std::printf("typos %u: \"%s\" matched %s, expected %s\n", distance, c.arg, name(got), name(c.expected[distance - 1])); }
+        }
+    }
+
+    //And the whole way through: "tool tell" is a program called with a word, not a help request
+    char tool[] = "tool", tell[] = "tell";
+    char* argv[] = { tool, tell, nullptr };
+    char out[64];
+    size_t length = 0;
+    const int matched = helpHandler::HelpHandler().withName("tool").withTypos(2).handle(2, argv, "usage: tool", helpHandler::sink(out, sizeof(out), &length));
+    if (matched != 0 || length != 0) {
+        mismatches++;
+        std::printf("typos 2: \"tool tell\" matched %d and printed %zu bytes\n", matched, length); }
+    return mismatches;
+    #endif
+}
+
+
+
+
+int main(int argc, char** argv) {
+    const unsigned long count = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 300000;
+    seed = argc > 2 ? (unsigned)std::strtoul(argv[2], nullptr, 10) : seed;
+
+    unsigned long checked = 0, mismatches = 0, matched[3] = { 0, 0, 0 };
+    for (bool extraStrings: { false, true }) {
+        const std::regex help = pattern(true, extraStrings), version = pattern(false, extraStrings);
+        seed += 1; //Different tokens for each setting
+        for (unsigned long i = 0; i < count; i++) {
+            const std::string arg = token();
+            const helpHandler::matchResult expected = std::regex_match(arg, help) ? helpHandler::matchHelp
+                                                    : std::regex_match(arg, version) ? helpHandler::matchVersion
+                                                    : helpHandler::matchNone;
+            matched[expected]++;
+
+            const size_t split = arg.empty() ? 0 : next() % (arg.size() + 1);
+            const unsigned char state = helpHandler::matchFrom(helpHandler::stateDash, arg.data(), split);
+            const helpHandler::matchResult got[] = {
+                helpHandler::matchArg(arg.data(), arg.size(), extraStrings),
+                helpHandler::matchState(helpHandler::matchFrom(state, arg.data() + split, arg.size() - split), extraStrings),
+                //NUL terminated, so only up to the first NUL, which is what argv would hold
+                std::strlen(arg.c_str()) == arg.size() ? helpHandler::matchArg(arg.c_str(), extraStrings) : expected,
+            };
+            for (const helpHandler::matchResult result: got) {
+                if (result != expected && ++mismatches <= 10) {
+                    std::printf("mismatch, extraStrings %d: \"", (int)extraStrings);
+                    for (unsigned char c: arg) {
+                        std::printf(c >= 0x20 && c < 0x7f ? "%c" : "\\x%02x", c); }
+                    std::printf("\" regex %s, DFA %s\n", name(expected), name(result));
+                }
+            }
+            checked++;
+        }
+    }
+
+    std::printf("%lu tokens, %lu help, %lu version, %lu neither, %lu mismatches\n",
+                checked, matched[helpHandler::matchHelp], matched[helpHandler::matchVersion], matched[helpHandler::matchNone], mismatches);
+    const unsigned long typoMismatches = typoCases();
+    std::printf("typo cases, %lu mismatches\n", typoMismatches);
+    mismatches += typoMismatches;
+    return mismatches == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
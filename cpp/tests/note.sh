@@ -0,0 +1,40 @@
+#!/bin/sh
+# Checks that helpscan reads back exactly what a binary prints: builds a C++ and a C program that use HELP_HANDLER_NOTE
+# (versions with surrounding spaces included, since they're registered verbatim), then compares each one's --version
+# output with "helpscan -r -v", and its --help output with the name and help helpscan reads
+#
+# sh note.sh (CXX and CC override the compilers, g++ and gcc by default)
+CXX=${CXX:-g++}
+CC=${CC:-gcc}
+DIR=$(cd "$(dirname "$0")" && pwd)
+TMP=$(mktemp -d)
+trap 'rm -rf "$TMP"' EXIT
+
+$CXX -std=c++11 -O2 -pthread "$DIR/../tools/helpscan.cpp" -o "$TMP/helpscan" || exit 1
+
+printf '#include "%s/../helpHandler.hpp"\nHELP_HANDLER_NOTE("app", " 3.0 rc1 ", "usage: app [--verbose]");\nint main(int argc, char** argv) { return helpHandler::handle(argc, argv, helpHandler::notedHelp()) < 0; }\n' "$DIR" > "$TMP/cpp.cpp"
+printf '#include "%s/../../c/help_handler.h"\nHELP_HANDLER_NOTE("capp", "2.10", "usage: capp [--verbose]");\nint main(int argc, char** argv) { return help_handler(argc, argv, help_handler_noted_help()) < 0; }\n' "$DIR" > "$TMP/c.c"
+$CXX -std=c++11 -O2 $CXXFLAGS "$TMP/cpp.cpp" -o "$TMP/cpp" || exit 1
+$CC -std=c99 -O2 $CFLAGS "$TMP/c.c" -o "$TMP/c" || exit 1
+
+status=0
+for app in cpp c; do
+    "$TMP/$app" --version > "$TMP/version"
+    "$TMP/helpscan" -r -v "$TMP/$app" > "$TMP/scanned"
+    if cmp -s "$TMP/version" "$TMP/scanned"; then
+        printf '%-4s --version matches helpscan: %s' $app "$(cat "$TMP/version")"; echo
+    else
+        echo "$app: --version and helpscan differ" >&2
+        od -c "$TMP/version" >&2
+        od -c "$TMP/scanned" >&2
+        status=1
+    fi
+
+    "$TMP/$app" --help > "$TMP/help"
+    printf '%s %s\n' "$("$TMP/helpscan" -r -n "$TMP/$app")" "$("$TMP/helpscan" -r -H "$TMP/$app")" > "$TMP/scanned"
+    if ! cmp -s "$TMP/help" "$TMP/scanned"; then
+        echo "$app: --help and helpscan differ" >&2
+        status=1
+    fi
+done
+exit $status
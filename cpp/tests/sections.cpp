@@ -0,0 +1,133 @@
+/*
+ * The section index: lookupSection() takes only a current index (size, mtime and its nanoseconds all as the file
+ * has them), turns down other versions, truncated and corrupt indexes and sections reaching past the file, and
+ * matches only whole topics. Then handleFile() the whole way through: a topic is printed, a garbage .idx on disk is
+ * rebuilt, and a file rewritten at the same size within the same second prints its new section, not the old
+ * offsets. Exits 1 on any failure
+ *
+ * g++ -std=c++11 -O2 sections.cpp -o sections && ./sections
+ */
+#include "../helpHandler.hpp"
+
+
+
+
+static int failures = 0;
+static void check(bool passed, const std::string& what) {
+    if (passed == false) {
+        failures++;
+        std::printf("failed: %s\n", what.c_str()); }
+}
+
+#ifdef HELP_HANDLER_POSIX_CPP
+static const char* fileName = "/tmp/help_handler_sections_test.txt";
+static const char* indexName = "/tmp/help_handler_sections_test.txt.idx";
+
+static void writeFile(const char* name, const std::string& text) {
+    FILE* fp = std::fopen(name, "wb");
+    std::fwrite(text.data(), 1, text.size(), fp);
+    std::fclose(fp);
+}
+
+static std::string header(const struct stat& st, long long sizeDelta = 0, long long mtimeDelta = 0, long long nsecDelta = 0) {
+    return "help_handler_index 2 " + std::to_string((long long)st.st_size + sizeDelta) + " "
+           + std::to_string((long long)st.st_mtime + mtimeDelta) + " " + std::to_string(helpHandler::mtimeNsec(st) + nsecDelta) + "\n";
+}
+
+static void parser() {
+    const std::string text = "usage: app\n[[one]]\nfirst\n[[done]]\r\nsecond\n[[two]]\nthird";
+    writeFile(fileName, text);
+    struct stat st;
+    ::stat(fileName, &st);
+    const std::string index = helpHandler::buildSectionIndex(text.data(), text.size(), st);
+    check(index == header(st) + "19 6 one\n35 7 done\n50 5 two\n", "built \"" + index + "\"");
+
+    const struct { const char* topic; int expected; size_t offset, length; } topics[] = {
+        { "one", 1, 19, 6 }, { "done", 1, 35, 7 }, { "two", 1, 50, 5 },
+        { "on", 0, 0, 0 }, { "ne", 0, 0, 0 }, { "three", 0, 0, 0 }, { "", 0, 0, 0 }, { "one two", 0, 0, 0 },
+    };
+    for (const auto& t: topics) {
+        helpHandler::helpSection found = { 0, 0 };
+        const int got = helpHandler::lookupSection(index, st, t.topic, found);
+        check(got == t.expected && (got != 1 || (found.offset == t.offset && found.length == t.length)),
+              std::string("topic \"") + t.topic + "\" gave " + std::to_string(got) + " at " + std::to_string(found.offset)
+              + "+" + std::to_string(found.length)); }
+
+    //Anything but a current, well formed index is stale
+    const std::string body = "19 6 one\n";
+    const struct { std::string index; const char* what; } stale[] = {
+        { "help_handler_index 1 " + std::to_string((long long)st.st_size) + " " + std::to_string((long long)st.st_mtime) + "\n" + body, "version 1" },
+        { header(st, 1) + body, "another size" },
+        { header(st, 0, 1) + body, "another second" },
+        { header(st, 0, 0, 1) + body, "the same second, another nanosecond" },
+        { "", "empty" },
+        { "garbage\n" + body, "not an index" },
+        { header(st) + "19 9999 one\n", "section past the end" },
+        { header(st) + "9999 1 one\n", "offset past the end" },
+        { header(st) + "19 x one\n", "no length" },
+        { header(st) + "19 6  one\n", "two spaces" },
+    };
+    for (const auto& s: stale) {
+        helpHandler::helpSection found;
+        check(helpHandler::lookupSection(s.index, st, "one", found) == -1, std::string("accepted an index with ") + s.what); }
+
+    //Every prefix of the index is either stale, current without the topic, or gives the right section
+    for (size_t cut = 0; cut < index.size(); cut++) {
+        helpHandler::helpSection found = { 0, 0 };
+        const int got = helpHandler::lookupSection(index.substr(0, cut), st, "done", found);
+        check(got != 1 || (found.offset == 35 && found.length == 7), "index cut at " + std::to_string(cut)); }
+}
+
+static std::string run(const helpHandler::HelpHandler& handler, const char* topic) {
+    char app[] = "app", help[] = "--help";
+    char* argv[] = { app, help, const_cast<char*>(topic), nullptr };
+    char out[256];
+    size_t length = 0;
+    handler.handleFile(3, argv, fileName, helpHandler::sink(out, sizeof(out), &length));
+    return std::string(out, length < sizeof(out) ? length : sizeof(out));
+}
+
+static void handleFile() {
+    const helpHandler::HelpHandler handler = helpHandler::HelpHandler().withName("app");
+    ::unlink(indexName);
+    writeFile(fileName, "usage\n[[a]]\nAAAA\n[[b]]\nBB\n");
+    check(run(handler, "b") == "app BB\n", "first lookup printed \"" + run(handler, "b") + "\"");
+    struct stat before;
+    check(::stat(indexName, &before) == 0, "no index written");
+
+    writeFile(indexName, "help_handler_index 2 garbage\n");
+    check(run(handler, "a") == "app AAAA\n", "lookup with a garbage index printed \"" + run(handler, "a") + "\"");
+
+    //Same size, other offsets, and the same second with another nanosecond: only the nanoseconds tell them apart
+    struct stat st;
+    ::stat(fileName, &st);
+    writeFile(fileName, "usage\n[[a]]\nAA\n[[b]]\nBBBB\n");
+    const long long nsec = helpHandler::mtimeNsec(st);
+    const struct timespec times[2] = { { 0, UTIME_OMIT }, { st.st_mtime, nsec < 999999999 ? nsec + 1 : nsec - 1 } };
+    ::utimensat(AT_FDCWD, fileName, times, 0);
+    struct stat rewritten;
+    ::stat(fileName, &rewritten);
+    if (helpHandler::mtimeNsec(rewritten) == nsec) {
+        std::printf("no nanosecond timestamps here, skipping the same-second rewrite\n");
+    } else {
+        check(rewritten.st_size == st.st_size && rewritten.st_mtime == st.st_mtime, "rewrite changed size or second");
+        check(run(handler, "b") == "app BBBB\n", "same-second rewrite printed \"" + run(handler, "b") + "\""); }
+
+    ::unlink(fileName);
+    ::unlink(indexName);
+}
+#endif
+
+
+
+
+int main() {
+    #ifdef HELP_HANDLER_POSIX_CPP
+    parser();
+    handleFile();
+    #else
+    std::printf("no sectioned help files without POSIX\n");
+    #endif
+    std::printf("%d failures\n", failures);
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
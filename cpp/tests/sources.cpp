@@ -0,0 +1,262 @@
+/*
+ * Argument sources: argReader splits response files like a plain reference splitter of GCC's syntax would (quotes,
+ * \ escapes, whitespace including \r) on fixed cases and on generated files big enough that arguments straddle
+ * buffer refills and outgrow the buffer, and splits stdin-style lines (dropping a \r before the \n) and NUL separated
+ * input. Then handle() with sources() on: nested @files up to 8 deep, a file naming itself, a missing file left as an
+ * ordinary argument, "--" inside a file, and stdin put back where it was. Exits 1 on any failure
+ *
+ * g++ -std=c++11 -O2 sources.cpp -o sources && ./sources [files=40] [seed]
+ */
+#include "../helpHandler.hpp"
+
+
+
+
+#if !defined(HELP_HANDLER_MINIMAL) && defined(HELP_HANDLER_POSIX_CPP)
+static const char* directory = "/tmp/help_handler_sources_test";
+static int failures = 0;
+static void check(bool passed, const std::string& what) {
+    if (passed == false) {
+        failures++;
+        std::printf("failed: %s\n", what.c_str()); }
+}
+
+static unsigned seed = 12345;
+static unsigned next() {
+    seed = seed * 1103515245 + 12345;
+    return seed >> 8;
+}
+
+static std::string path(const std::string& name) {
+    return std::string(directory) + "/" + name;
+}
+
+static void writeFile(const std::string& name, const std::string& text) {
+    FILE* fp = std::fopen(name.c_str(), "wb");
+    std::fwrite(text.data(), 1, text.size(), fp);
+    std::fclose(fp);
+}
+
+//GCC's response file syntax, the slow and obvious way
+static std::vector<std::string> reference(const std::string& text) {
+    std::vector<std::string> args;
+    std::string arg;
+    bool inArg = false, escaped = false;
+    char quote = 0;
+    for (const char c: text) {
+        if (escaped) {
+            escaped = false;
+            arg += c;
+        } else if (c == '\\') {
+            escaped = inArg = true;
+        } else if (quote != 0) {
+            if (c == quote) {
+                quote = 0;
+            } else {
+                arg += c; }
+        } else if (c == '\'' || c == '"') {
+            quote = c;
+            inArg = true;
+        } else if (std::strchr(" \t\n\r\v\f", c) != nullptr && c != '\0') {
+            if (inArg) {
+                args.push_back(arg); }
+            arg.clear();
+            inArg = false;
+        } else {
+            arg += c;
+            inArg = true; }
+    }
+    if (inArg) {
+        args.push_back(arg); }
+    return args;
+}
+
+//What argReader hands out, with the pieces of over-long arguments joined back up
+static std::vector<std::string> split(helpHandler::argReader& reader) {
+    std::vector<std::string> args;
+    std::string pieces;
+    helpHandler::fragment arg;
+    bool complete;
+    while (reader.next(arg, complete)) {
+        pieces.append(arg.data, arg.size);
+        if (complete) {
+            args.push_back(pieces);
+            pieces.clear(); }
+    }
+    return args;
+}
+
+static std::string show(const std::vector<std::string>& args) {
+    std::string out;
+    for (const std::string& arg: args) {
+        out += (out.empty() ? "[" : ", [") + (arg.size() > 40 ? arg.substr(0, 40) + "...(" + std::to_string(arg.size()) + ")" : arg) + "]"; }
+    return out;
+}
+
+static void responseFileSyntax(unsigned files) {
+    const struct { const char* text; std::vector<std::string> expected; } cases[] = {
+        { "a b\tc\n d", { "a", "b", "c", "d" } },
+        { "'a b' \"c d\" e'f g'h", { "a b", "c d", "ef gh" } },
+        { "a\\ b \\\"q\\\" \\\\ \\'", { "a b", "\"q\"", "\\", "'" } },
+        { "'' \"\" x", { "", "", "x" } },
+        { "\"it's\" 'say \"hi\"'", { "it's", "say \"hi\"" } },
+        { "a\r\nb\r\n", { "a", "b" } },
+        { "'unterminated quote", { "unterminated quote" } },
+        { "trailing\\", { "trailing" } },
+        { "", {} },
+        { " \n\t ", {} },
+        { "--help @other\n", { "--help", "@other" } },
+    };
+    const std::string name = path("syntax.rsp");
+    for (const auto& c: cases) {
+        writeFile(name, c.text);
+        helpHandler::argReader reader(name.c_str());
+        const std::vector<std::string> got = split(reader);
+        check(got == c.expected, "\"" + std::string(c.text) + "\" split into " + show(got) + ", expected " + show(c.expected)); }
+
+    //Generated files: mostly short arguments, with runs long enough to straddle a refill or fill the buffer outright
+    static const char alphabet[] = "ab-\\'\"  \n\r\t";
+    for (unsigned f = 0; f < files; f++) {
+        std::string text;
+        const size_t size = next() % 3 == 0 ? 1 + next() % 4096 : helpHandler::argReader::bufferSize - 4096 + next() % 150000;
+        while (text.size() < size) {
+            if (next() % 2000 == 0) {
+                text.append(next() % 3 == 0 ? helpHandler::argReader::bufferSize + next() % 1000 : next() % 5000, (char)('c' + next() % 20));
+            } else {
+                text += alphabet[next() % (sizeof(alphabet) - 1)]; }
+        }
+        writeFile(name, text);
+        helpHandler::argReader reader(name.c_str());
+        const std::vector<std::string> got = split(reader), expected = reference(text);
+        check(got == expected, "generated file " + std::to_string(f) + " of " + std::to_string(text.size()) + " bytes split into "
+                               + std::to_string(got.size()) + " arguments, expected " + std::to_string(expected.size()));
+    }
+}
+
+static std::vector<std::string> splitStream(const std::string& text, helpHandler::argReader::syntax format) {
+    const std::string name = path("stream");
+    writeFile(name, text);
+    const int fd = ::open(name.c_str(), O_RDONLY);
+    std::vector<std::string> args;
+    {
+        helpHandler::argReader reader(fd, format);
+        args = split(reader);
+    }
+    ::close(fd);
+    return args;
+}
+
+static void streamSyntax() {
+    const struct { std::string text; helpHandler::argReader::syntax format; std::vector<std::string> expected; } cases[] = {
+        { "a\r\nb c\n\nd", helpHandler::argReader::lines, { "a", "b c", "", "d" } },
+        { "'quoted'\r\n\\\r\n", helpHandler::argReader::lines, { "'quoted'", "\\" } },
+        { "only\r", helpHandler::argReader::lines, { "only" } },
+        { "a\r\rb\n", helpHandler::argReader::lines, { "a\r\rb" } },
+        { std::string("a b\0c\r\n\0\0d", 11), helpHandler::argReader::nulSeparated, { "a b", "c\r\n", "", "d" } },
+    };
+    for (const auto& c: cases) {
+        const std::vector<std::string> got = splitStream(c.text, c.format);
+        check(got == c.expected, "stream split into " + show(got) + ", expected " + show(c.expected)); }
+}
+
+static int run(const helpHandler::HelpHandler& handler, std::vector<std::string> args, std::string& printed) {
+    std::vector<char*> argv;
+    for (std::string& arg: args) {
+        argv.push_back(&arg[0]); }
+    argv.push_back(nullptr);
+    char out[256];
+    size_t length = 0;
+    const int matched = handler.handle((int)args.size(), argv.data(), "usage: app", helpHandler::sink(out, sizeof(out), &length));
+    printed.assign(out, length < sizeof(out) ? length : sizeof(out));
+    return matched;
+}
+
+static void expandFiles() {
+    const helpHandler::HelpHandler handler = helpHandler::HelpHandler().withName("app").withVersion("1.0")
+                                                 .withSources(helpHandler::responseFiles);
+
+    //d1 names d2, which names d3... and only dk holds --help. The 8th file is still read, the 9th no longer
+    for (unsigned k = 1; k <= 10; k++) {
+        for (unsigned d = 1; d <= 10; d++) {
+            writeFile(path("d" + std::to_string(d)), d == k ? "x --help" : "x @" + path("d" + std::to_string(d + 1))); }
+        std::string printed;
+        const int matched = run(handler, { "app", "@" + path("d1") }, printed);
+        check(matched == (k <= 8 ? 1 : 0), "--help " + std::to_string(k) + " files deep matched " + std::to_string(matched)); }
+
+    const struct { std::string text; int expected; const char* what; } files[] = {
+        { "@" + path("self.rsp") + " x", 0, "a file naming itself" },
+        { "'--he'lp", 1, "quoted --help" },
+        { "--\\help", 1, "escaped --help" },
+        { "\"x --help\"", 0, "one quoted argument with a space" },
+        { "x\r\n--version\r\n", 1, "CRLF lines" },
+        { "-- --help", 0, "--help after --" },
+        { "@" + path("missing.rsp"), 0, "a missing file inside a file" },
+    };
+    for (const auto& f: files) {
+        writeFile(path("self.rsp"), f.text);
+        std::string printed;
+        check(run(handler, { "app", "@" + path("self.rsp") }, printed) == f.expected, f.what); }
+
+    std::string printed;
+    check(run(handler, { "app", "@" + path("missing.rsp") }, printed) == 0 && printed.empty(), "a missing file printed \"" + printed + "\"");
+    writeFile(path("version.rsp"), "--version");
+    check(run(handler, { "app", "@" + path("version.rsp"), "--", "--help" }, printed) == 1 && printed == "1.0\n",
+          "@file then \"--\" printed \"" + printed + "\"");
+    check(run(helpHandler::HelpHandler().withName("app"), { "app", "@" + path("version.rsp") }, printed) == 0,
+          "@file expanded without sources()");
+}
+
+//stdin read after argv, then put back so the program reads it whole
+static void readStdin() {
+    const int saved = ::dup(0);
+    const struct { std::string text; unsigned source; int expected; } cases[] = {
+        { "x\r\n--help\r\n", helpHandler::stdinLines, 1 },
+        { "x\n'--help'\n", helpHandler::stdinLines, 0 }, //Lines aren't unquoted
+        { std::string("x\0--help\0", 9), helpHandler::stdinNul, 1 },
+        { "x\n--help\n", helpHandler::stdinNul, 0 },
+    };
+    for (const auto& c: cases) {
+        writeFile(path("stdin"), c.text);
+        const int fd = ::open(path("stdin").c_str(), O_RDONLY);
+        ::dup2(fd, 0);
+        ::close(fd);
+        std::string printed;
+        const int matched = run(helpHandler::HelpHandler().withName("app").withSources(c.source), { "app" }, printed);
+        check(matched == c.expected, "stdin \"" + c.text + "\" matched " + std::to_string(matched));
+
+        char back[64];
+        const ssize_t got = ::read(0, back, sizeof(back));
+        check(got == (ssize_t)c.text.size() && std::memcmp(back, c.text.data(), c.text.size()) == 0, "stdin wasn't put back");
+    }
+    ::dup2(saved, 0);
+    ::close(saved);
+}
+#endif
+
+
+
+
+int main(int argc, char** argv) {
+    #if defined(HELP_HANDLER_MINIMAL) || !defined(HELP_HANDLER_POSIX_CPP)
+    (void)argc; (void)argv;
+    std::printf("no argument sources in this build\n");
+    return 0;
+    #else
+    const unsigned files = argc > 1 ? (unsigned)std::strtoul(argv[1], nullptr, 10) : 40;
+    seed = argc > 2 ? (unsigned)std::strtoul(argv[2], nullptr, 10) : seed;
+    ::mkdir(directory, 0755);
+    responseFileSyntax(files);
+    streamSyntax();
+    expandFiles();
+    readStdin();
+
+    const char* names[] = { "syntax.rsp", "stream", "self.rsp", "version.rsp", "stdin" };
+    for (const char* name: names) {
+        ::unlink(path(name).c_str()); }
+    for (unsigned d = 1; d <= 10; d++) {
+        ::unlink(path("d" + std::to_string(d)).c_str()); }
+    ::rmdir(directory);
+    std::printf("%d failures\n", failures);
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+    #endif
+}
@@ -0,0 +1,112 @@
+/* MIT License
+ *
+ * Copyright (c) 2021 Inaff
+
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*
+ * helpbundle - packs the help text of every locale into one compressed bundle for helpHandler::handleBundle() (see
+ * "Help bundles" in the README), or lists what a bundle holds
+ *
+ * usage: helpbundle <bundle> <locale>=<help file>...
+ *        helpbundle -l <bundle>
+ *   -l  list each locale's topics with their sizes, compressed and not
+ *
+ * Locales are named as in LANG without the codeset, "en", "de_DE" or "pt_BR" say. The first one given is the
+ * default, printed when the environment names a locale the bundle doesn't have. Help files are split into topics
+ * at their [[topic]] lines, like sectioned help files
+ *
+ * g++ -std=c++11 -O2 helpbundle.cpp -o helpbundle
+ * ./helpbundle help.hhb en=help.txt de=help.de.txt fr=help.fr.txt && ./helpbundle -l help.hhb
+ */
+#include "../helpHandler.hpp"
+
+#include <unistd.h>
+
+
+
+
+static int list(const char* fileName) {
+    std::ifstream file(fileName, std::ios::binary);
+    if (!file) {
+        std::perror(fileName);
+        return EXIT_FAILURE; }
+
+    const std::string data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    const helpHandler::bundleView bundle(data.data(), data.size());
+    const helpHandler::fragment fallback = bundle.localeCount() > 0 ? bundle.localeName(bundle.findLocale(nullptr)) : helpHandler::fragment{ "none", 4 };
+    std::printf("%s: %zu bytes, %u locales, %.*s by default\n", fileName, data.size(), bundle.localeCount(), (int)fallback.size, fallback.data);
+
+    for (uint32_t l = 0; l < bundle.localeCount(); l++) {
+        const helpHandler::fragment name = bundle.localeName(l);
+        std::printf("%.*s\n", (int)name.size, name.data);
+        for (uint32_t e = bundle.firstEntry(l); e < bundle.firstEntry(l) + bundle.entryCount(l); e++) {
+            const helpHandler::fragment topic = bundle.topic(e);
+            std::string text(bundle.textSize(e), '\0');
+            if (bundle.decompress(e, &text[0]) == false) {
+                throw std::runtime_error("Help bundle is corrupt"); }
+            std::printf("  %-32.*s %10u bytes %10u compressed\n", topic.size > 0 ? (int)topic.size : 10, topic.size > 0 ? topic.data : "(no topic)",
+                        bundle.textSize(e), bundle.blockSize(e));
+        }
+    }
+    return EXIT_SUCCESS;
+}
+
+int main(int argc, char** argv) {
+    bool listing = false;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "l")) != -1) {
+        switch (opt) {
+            case 'l': listing = true; break;
+            default:
+                std::fprintf(stderr, "usage: %s <bundle> <locale>=<help file>...\n       %s -l <bundle>\n", argv[0], argv[0]);
+                return EXIT_FAILURE;
+        }
+    }
+    if (listing ? argc - optind != 1 : argc - optind < 2) {
+        std::fprintf(stderr, "usage: %s <bundle> <locale>=<help file>...\n       %s -l <bundle>\n", argv[0], argv[0]);
+        return EXIT_FAILURE; }
+
+    try {
+        if (listing) {
+            return list(argv[optind]); }
+
+        helpHandler::bundleWriter bundle;
+        for (int i = optind + 1; i < argc; i++) {
+            const char* split = std::strchr(argv[i], '=');
+            if (split == nullptr) {
+                std::fprintf(stderr, "%s: expected <locale>=<help file>, got %s\n", argv[0], argv[i]);
+                return EXIT_FAILURE; }
+
+            std::ifstream file(split + 1, std::ios::binary);
+            if (!file) {
+                std::perror(split + 1);
+                return EXIT_FAILURE; }
+            bundle.add(std::string(argv[i], (size_t)(split - argv[i])), std::string((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>()));
+        }
+        bundle.save(argv[optind]);
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "%s: %s\n", argv[0], e.what());
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,93 @@
+/* MIT License
+ *
+ * Copyright (c) 2021 Inaff
+
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*
+ * helpindex - builds the topic index for sectioned help files (see "Sectioned help files" in the README) ahead of
+ * time, so the first "--help topic" after a release doesn't have to scan the file. handleFile()/help_handler_f()
+ * rebuild a stale index on their own as well; this is for read-only installs and build steps
+ *
+ * usage: helpindex [-l] <help file>...
+ *   -l  list each file's topics with their sizes instead of only writing the index
+ *
+ * Writes <help file>.idx next to each help file
+ *
+ * g++ -std=c++11 -O2 helpindex.cpp -o helpindex
+ */
+#include "../helpHandler.hpp"
+
+
+
+
+int main(int argc, char** argv) {
+    bool list = false;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "l")) != -1) {
+        switch (opt) {
+            case 'l': list = true; break;
+            default:
+                std::fprintf(stderr, "usage: %s [-l] <help file>...\n", argv[0]);
+                return EXIT_FAILURE;
+        }
+    }
+    if (optind == argc) {
+        std::fprintf(stderr, "usage: %s [-l] <help file>...\n", argv[0]);
+        return EXIT_FAILURE; }
+
+    int status = EXIT_SUCCESS;
+    for (int i = optind; i < argc; i++) {
+        const std::string fileName = argv[i];
+        std::string data;
+        struct stat st;
+        if (helpHandler::readSmallFile(fileName, data) == false || ::stat(fileName.c_str(), &st) != 0) {
+            std::perror(argv[i]);
+            status = EXIT_FAILURE;
+            continue; }
+        if ((size_t)st.st_size != data.size()) { //Changed while it was being read
+            std::fprintf(stderr, "%s: changed while being read\n", argv[i]);
+            status = EXIT_FAILURE;
+            continue; }
+
+        const std::string index = helpHandler::buildSectionIndex(data.data(), data.size(), st);
+        helpHandler::writeSectionIndex(fileName, index);
+
+        helpHandler::helpSection section;
+        std::string check;
+        if (helpHandler::readSmallFile(fileName + ".idx", check) == false || helpHandler::lookupSection(check, st, "", section) < 0) {
+            std::fprintf(stderr, "%s: could not write %s.idx\n", argv[i], argv[i]);
+            status = EXIT_FAILURE;
+            continue; }
+
+        const size_t topics = (size_t)std::count(index.begin(), index.end(), '\n') - 1;
+        std::printf("%s: %zu topics\n", argv[i], topics);
+        if (list) {
+            //Entries are "<offset> <length> <topic>", after the header line
+            for (size_t at = index.find('\n') + 1; at < index.size(); at = index.find('\n', at) + 1) {
+                const size_t end = index.find('\n', at);
+                const size_t lengthAt = index.find(' ', at) + 1, topicAt = index.find(' ', lengthAt) + 1;
+                std::printf("  %-32s %10s bytes\n", index.substr(topicAt, end - topicAt).c_str(), index.substr(lengthAt, topicAt - 1 - lengthAt).c_str()); }
+        }
+    }
+
+    return status;
+}
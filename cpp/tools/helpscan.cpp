@@ -0,0 +1,266 @@
+/* MIT License
+ *
+ * Copyright (c) 2021 Inaff
+
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*
+ * helpscan - reads the note left by HELP_HANDLER_NOTE out of ELF binaries without executing them
+ *
+ * usage: helpscan [-v|-n|-H] [-r] [-j threads] <file or directory>...
+ *   -v  print the version, exactly as --version would (default)
+ *   -n  print the name
+ *   -H  print the help dialogue
+ *   -r  raw output, without the "path: " prefix
+ *   -j  number of threads (defaults to the number of cores)
+ *
+ * Directories are walked recursively. Binaries without the note are skipped silently
+ *
+ * g++ -std=c++11 -O2 -pthread helpscan.cpp -o helpscan
+ */
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+
+#include <ftw.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+
+
+
+struct result_t {
+    bool found = false;
+    std::string name;
+    std::string version;
+    std::string help;
+};
+
+static std::vector<std::string> files;
+
+
+/*
+ * ELF parsing
+ * Only what's needed to find notes: the file header, then PT_NOTE segments, or SHT_NOTE sections when
+ * there are no program headers (relocatable objects). Every read is bounds checked against the mapping
+ */
+class elfReader {
+public:
+    elfReader(const unsigned char* data, size_t size) : data(data), size(size) {}
+
+    bool valid() {
+        if (size < 52 || std::memcmp(data, "\x7f" "ELF", 4) != 0) {
+            return false; }
+        if (data[4] != 1 && data[4] != 2) { //ELFCLASS32/64
+            return false; }
+        if (data[5] != 1 && data[5] != 2) { //ELFDATA2LSB/MSB
+            return false; }
+
+        is64 = data[4] == 2;
+        bigEndian = data[5] == 2;
+        return size >= (is64 ? 64u : 52u);
+    }
+
+    bool find(result_t& result) {
+        uint64_t phoff     = word(is64 ? 0x20 : 0x1c);
+        uint64_t phentsize = half(is64 ? 0x36 : 0x2a);
+        uint64_t phnum     = half(is64 ? 0x38 : 0x2c);
+        for (uint64_t i = 0; phoff != 0 && i < phnum; i++) {
+            uint64_t ph = phoff + i * phentsize;
+            if (u32(ph) != 4) { continue; } //PT_NOTE
+
+            uint64_t offset = word(ph + (is64 ? 0x08 : 0x04));
+            uint64_t length = word(ph + (is64 ? 0x20 : 0x10));
+            uint64_t align  = word(ph + (is64 ? 0x30 : 0x1c));
+            if (notes(offset, length, align, result)) {
+                return true; }
+        }
+        if (phnum != 0) {
+            return false; }
+
+        uint64_t shoff     = word(is64 ? 0x28 : 0x20);
+        uint64_t shentsize = half(is64 ? 0x3a : 0x2e);
+        uint64_t shnum     = half(is64 ? 0x3c : 0x30);
+        for (uint64_t i = 0; shoff != 0 && i < shnum; i++) {
+            uint64_t sh = shoff + i * shentsize;
+            if (u32(sh + 4) != 7) { continue; } //SHT_NOTE
+
+            uint64_t offset = word(sh + (is64 ? 0x18 : 0x10));
+            uint64_t length = word(sh + (is64 ? 0x20 : 0x14));
+            uint64_t align  = word(sh + (is64 ? 0x30 : 0x20));
+            if (notes(offset, length, align, result)) {
+                return true; }
+        }
+
+        return false;
+    }
+
+private:
+    const unsigned char* data;
+    size_t size;
+    bool is64      = false;
+    bool bigEndian = false;
+
+    uint64_t read(uint64_t offset, unsigned width) const {
+        if (offset > size || width > size - offset) {
+            return 0; }
+
+        uint64_t value = 0;
+        for (unsigned i = 0; i < width; i++) {
+            unsigned shift = bigEndian ? (width - 1 - i) * 8 : i * 8;
+            value |= (uint64_t)data[offset + i] << shift; }
+        return value;
+    }
+    uint64_t half(uint64_t offset) const { return read(offset, 2); }
+    uint64_t u32(uint64_t offset) const  { return read(offset, 4); }
+    uint64_t word(uint64_t offset) const { return read(offset, is64 ? 8 : 4); }
+
+    bool notes(uint64_t offset, uint64_t length, uint64_t align, result_t& result) const {
+        if (offset > size || length > size - offset) {
+            return false; }
+
+        //Notes are 4-byte aligned, except in 8-byte aligned segments such as .note.gnu.property
+        const uint64_t pad = align == 8 ? 7 : 3;
+        uint64_t pos = offset;
+        const uint64_t end = offset + length;
+        while (pos + 12 <= end) {
+            uint64_t nameSize = u32(pos);
+            uint64_t descSize = u32(pos + 4);
+            uint64_t type     = u32(pos + 8);
+            uint64_t name     = pos + 12;
+            uint64_t desc     = (name + nameSize + pad) & ~pad;
+            if (nameSize > end - name || desc > end || descSize > end - desc) {
+                return false; }
+
+            if (type == 1 && nameSize == 12 && std::memcmp(data + name, "HelpHandler", 12) == 0) {
+                //desc is "name\0version\0help\0"
+                const char* field = (const char*)data + desc;
+                const char* last  = field + descSize;
+                std::string* out[] = { &result.name, &result.version, &result.help };
+                for (int i = 0; i < 3 && field < last; i++) {
+                    const char* stop = (const char*)std::memchr(field, '\0', (size_t)(last - field));
+                    if (stop == nullptr) { stop = last; }
+                    out[i]->assign(field, (size_t)(stop - field));
+                    field = stop + 1; }
+
+                result.found = true;
+                return true;
+            }
+
+            pos = (desc + descSize + pad) & ~pad;
+        }
+
+        return false;
+    }
+};
+
+
+static void scan(const std::string& path, result_t& result) {
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return; }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size < 52) {
+        close(fd);
+        return; }
+
+    void* data = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        return; }
+
+    elfReader elf((const unsigned char*)data, (size_t)st.st_size);
+    if (elf.valid()) {
+        elf.find(result); }
+
+    munmap(data, (size_t)st.st_size);
+}
+
+static int collect(const char* path, const struct stat* st, int type, struct FTW*) {
+    if (type == FTW_F && S_ISREG(st->st_mode)) {
+        files.push_back(path); }
+    return 0;
+}
+
+
+
+
+int main(int argc, char** argv) {
+    char field = 'v';
+    bool raw = false;
+    unsigned threads = std::thread::hardware_concurrency();
+
+    int opt;
+    while ((opt = getopt(argc, argv, "vnHrj:")) != -1) {
+        switch (opt) {
+            case 'v': case 'n': case 'H': field = (char)opt; break;
+            case 'r': raw = true; break;
+            case 'j': threads = (unsigned)std::strtoul(optarg, nullptr, 10); break;
+            default:
+                std::fprintf(stderr, "usage: %s [-v|-n|-H] [-r] [-j threads] <file or directory>...\n", argv[0]);
+                return EXIT_FAILURE;
+        }
+    }
+    if (optind >= argc) {
+        std::fprintf(stderr, "usage: %s [-v|-n|-H] [-r] [-j threads] <file or directory>...\n", argv[0]);
+        return EXIT_FAILURE; }
+    if (threads == 0) {
+        threads = 1; }
+
+    for (int i = optind; i < argc; i++) {
+        if (nftw(argv[i], collect, 64, FTW_PHYS) != 0) {
+            std::perror(argv[i]); }
+    }
+
+    //Workers pull the next file off a shared counter, results land in their own slot so output order is stable
+    std::vector<result_t> results(files.size());
+    std::atomic<size_t> next(0);
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < threads && t < files.size(); t++) {
+        workers.emplace_back([&]() {
+            for (size_t i = next++; i < files.size(); i = next++) {
+                scan(files[i], results[i]); }
+        });
+    }
+    for (auto& worker: workers) {
+        worker.join(); }
+
+    //The trailing newline matches what handle()/help_handler() print after the version
+    for (size_t i = 0; i < files.size(); i++) {
+        if (results[i].found == false) { continue; }
+
+        const std::string& text = field == 'n' ? results[i].name : field == 'H' ? results[i].help : results[i].version;
+        if (raw == false) {
+            std::fputs(files[i].c_str(), stdout);
+            std::fputs(": ", stdout); }
+        std::fwrite(text.data(), 1, text.size(), stdout);
+        std::fputc('\n', stdout);
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,100 @@
+/* MIT License
+ *
+ * Copyright (c) 2021 Inaff
+
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*
+ * suggestgen - builds the "did you mean" index for helpHandler::suggest() ahead of time, so applications with
+ * thousands of options load it instead of building it on every startup
+ *
+ * usage: suggestgen [-d distance] [-c symbol] <names file> <output file>
+ *   -d  largest distance suggested (default 2)
+ *   -c  write a C++ header defining `static const unsigned char symbol[]` to embed, instead of the binary index
+ *
+ * The names file has one option or subcommand name per line; blank lines are skipped
+ *
+ * g++ -std=c++11 -O2 suggestgen.cpp -o suggestgen
+ *
+ * Loading it back:
+ *   static const auto index = helpHandler::suggestionIndex::loadFile("options.idx");
+ *   static const auto index = helpHandler::suggestionIndex::load((const char*)symbol, sizeof(symbol));
+ */
+#include "../helpHandler.hpp"
+
+#include <unistd.h>
+
+
+
+
+int main(int argc, char** argv) {
+    unsigned distance = 2;
+    const char* symbol = nullptr;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "d:c:")) != -1) {
+        switch (opt) {
+            case 'd': distance = (unsigned)std::strtoul(optarg, nullptr, 10); break;
+            case 'c': symbol = optarg; break;
+            default:
+                std::fprintf(stderr, "usage: %s [-d distance] [-c symbol] <names file> <output file>\n", argv[0]);
+                return EXIT_FAILURE;
+        }
+    }
+    if (argc - optind != 2) {
+        std::fprintf(stderr, "usage: %s [-d distance] [-c symbol] <names file> <output file>\n", argv[0]);
+        return EXIT_FAILURE; }
+
+    std::ifstream names(argv[optind]);
+    if (!names) {
+        std::perror(argv[optind]);
+        return EXIT_FAILURE; }
+
+    helpHandler::suggestionIndex index(distance);
+    std::string name;
+    try {
+        while (std::getline(names, name)) {
+            if (!name.empty() && name.back() == '\r') {
+                name.pop_back(); }
+            if (!name.empty()) {
+                index.add(name); }
+        }
+
+        if (symbol == nullptr) {
+            index.save(argv[optind + 1]);
+        } else {
+            const std::string data = index.serialize();
+            std::ofstream header(argv[optind + 1]);
+            header << "//Generated by suggestgen from " << argv[optind] << ", " << index.size() << " names\n";
+            header << "static const unsigned char " << symbol << "[] = {";
+            for (size_t i = 0; i < data.size(); i++) {
+                header << (i % 16 == 0 ? "\n    " : " ") << (unsigned)(unsigned char)data[i] << ",";
+            }
+            header << "\n};\n";
+            if (!header) {
+                throw std::ios_base::failure("Could not write header"); }
+        }
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "%s: %s\n", argv[0], e.what());
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}